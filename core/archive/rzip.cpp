@@ -18,6 +18,8 @@
 */
 #include "rzip.h"
 #include <zlib.h>
+#include <atomic>
+#include <vector>
 
 const u8 RZipHeader[8] = { '#', 'R', 'Z', 'I', 'P', 'v', 1, '#' };
 
@@ -84,6 +86,49 @@ void RZipFile::Close()
 	}
 }
 
+// Read and decompress whole chunks directly into the destination buffer.
+// Chunks are decompressed in parallel.
+size_t RZipFile::ReadChunks(u8 *dest, u32 count)
+{
+	std::vector<std::vector<u8>> zipped(count);
+	u32 read = 0;
+	for (; read < count; read++)
+	{
+		u32 zippedSize;
+		if (std::fread(&zippedSize, sizeof(zippedSize), 1, file) != 1)
+			break;
+		zipped[read].resize(zippedSize);
+		if (zippedSize != 0 && std::fread(zipped[read].data(), zippedSize, 1, file) != 1)
+			break;
+	}
+	std::vector<uLongf> sizes(read, 0);
+	std::atomic<bool> error { false };
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for (int i = 0; i < (int)read; i++)
+	{
+		if (zipped[i].empty())
+			continue;
+		uLongf tl = maxChunkSize;
+		if (uncompress(dest + (size_t)i * maxChunkSize, &tl, zipped[i].data(), (uLong)zipped[i].size()) != Z_OK)
+			error = true;
+		else
+			sizes[i] = tl;
+	}
+	if (error)
+		return 0;
+	// Chunks should all be full except the last one, but compact the data if needed
+	size_t rv = 0;
+	for (u32 i = 0; i < read; i++)
+	{
+		if (rv != (size_t)i * maxChunkSize)
+			memmove(dest + rv, dest + (size_t)i * maxChunkSize, sizes[i]);
+		rv += sizes[i];
+	}
+	return rv;
+}
+
 size_t RZipFile::Read(void *data, size_t length)
 {
 	verify(file != nullptr);
@@ -93,6 +138,16 @@ size_t RZipFile::Read(void *data, size_t length)
 	size_t rv = 0;
 	while (rv < length)
 	{
+		if (chunkIndex == chunkSize && length - rv >= maxChunkSize)
+		{
+			u32 count = (u32)std::min<size_t>((length - rv) / maxChunkSize, 64);
+			size_t l = ReadChunks(p, count);
+			if (l == 0)
+				break;
+			p += l;
+			rv += l;
+			continue;
+		}
 		if (chunkIndex == chunkSize)
 		{
 			chunkSize = 0;
@@ -136,29 +191,37 @@ size_t RZipFile::Write(const void *data, size_t length)
 	const u8 *p = (const u8 *)data;
 	// compression output buffer must be 0.1% larger + 12 bytes
 	uLongf maxZippedSize = maxChunkSize + maxChunkSize / 1000 + 12;
-	u8 *zipped = new u8[maxZippedSize];
-	size_t rv = 0;
-	while (rv < length)
+	const int chunkCount = (int)((length + maxChunkSize - 1) / maxChunkSize);
+	// Compress all chunks in parallel, then write them in order
+	std::vector<std::vector<u8>> zipped(chunkCount);
+	std::atomic<bool> error { false };
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for (int i = 0; i < chunkCount; i++)
 	{
+		size_t offset = (size_t)i * maxChunkSize;
+		uLongf uncompressedSize = std::min<size_t>(maxChunkSize, length - offset);
+		zipped[i].resize(maxZippedSize);
 		uLongf zippedSize = maxZippedSize;
-		uLongf uncompressedSize = std::min(maxChunkSize, (u32)(length - rv));
-		u32 rc = compress(zipped, &zippedSize, p, uncompressedSize);
+		int rc = compress(zipped[i].data(), &zippedSize, p + offset, uncompressedSize);
 		if (rc != Z_OK)
 		{
 			WARN_LOG(SAVESTATE, "Compression error: %d", rc);
-			break;
+			error = true;
 		}
-		u32 sz = (u32)zippedSize;
+		zipped[i].resize(zippedSize);
+	}
+	if (error)
+		return 0;
+
+	for (const auto& chunk : zipped)
+	{
+		u32 sz = (u32)chunk.size();
 		if (std::fwrite(&sz, sizeof(sz), 1, file) != 1
-			|| std::fwrite(zipped, zippedSize, 1, file) != 1)
-		{
-			rv = 0;
-			break;
-		}
-		p += uncompressedSize;
-		rv += uncompressedSize;
+			|| std::fwrite(chunk.data(), chunk.size(), 1, file) != 1)
+			return 0;
 	}
-	delete [] zipped;
-	
-	return rv;
+
+	return length;
 }
@@ -35,6 +35,8 @@ public:
 	FILE *rawFile() const { return file; }
 
 private:
+	size_t ReadChunks(u8 *dest, u32 count);
+
 	FILE *file = nullptr;
 	u64 size = 0;
 	u32 maxChunkSize = 0;
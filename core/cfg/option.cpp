@@ -58,6 +58,9 @@ Option<bool> AutoLatency("aica.AutoLatency",
 		false
 #endif
 		);
+Option<bool> ThreadedSoundCpu("aica.ThreadedSoundCpu");
+Option<bool> AudioRingBuffer("aica.RingBuffer");
+Option<int> AudioRingLatency("aica.RingLatency", 2205);	// 50 ms
 
 OptionString AudioBackend("backend", "auto", "audio");
 AudioVolumeOption AudioVolume;
@@ -74,12 +77,14 @@ Option<bool> TranslucentPolygonDepthMask("rend.TranslucentPolygonDepthMask");
 Option<bool> ModifierVolumes("rend.ModifierVolumes", true);
 Option<int> TextureUpscale("rend.TextureUpscale", 1);
 Option<int> MaxFilteredTextureSize("rend.MaxFilteredTextureSize", 256);
+Option<bool> BackgroundTextureUpscaling("rend.BackgroundTextureUpscaling");
 Option<float> ExtraDepthScale("rend.ExtraDepthScale", 1.f);
 Option<bool> CustomTextures("rend.CustomTextures");
 Option<bool> DumpTextures("rend.DumpTextures");
 Option<int> ScreenStretching("rend.ScreenStretching", 100);
 Option<bool> Fog("rend.Fog", true);
 Option<bool> FloatVMUs("rend.FloatVMUs");
+Option<bool> ShowFrameTiming("rend.ShowFrameTiming");
 Option<bool> Rotate90("rend.Rotate90");
 Option<bool> PerStripSorting("rend.PerStripSorting");
 Option<bool> DelayFrameSwapping("rend.DelayFrameSwapping", false);
@@ -110,6 +115,7 @@ Option<int> FixedFrequency ("rend.FixedFrequency", 1);
 Option<bool> FixedFrequencyThreadSleep("rend.FixedFrequencyThreadSleep", false);
 Option<bool> EmulateFramebuffer("rend.EmulateFramebuffer", false);
 Option<bool> FixUpscaleBleedingEdge("rend.FixUpscaleBleedingEdge", true);
+Option<int> RunAhead("rend.RunAhead", 0);
 
 // Misc
 
@@ -118,6 +124,8 @@ Option<bool> SerialPTY("Debug.SerialPTY");
 Option<bool> GDB("Debug.GDBEnabled");
 Option<int> GDBPort("Debug.GDBPort", debugger::DEFAULT_PORT);
 Option<bool> GDBWaitForConnection("Debug.GDBWaitForConnection");
+Option<int> LatencyTest("Debug.LatencyTest", 0);
+Option<int> SH4Profiler("Debug.SH4Profiler", 0);
 Option<bool> UseReios("UseReios");
 Option<bool> FastGDRomLoad("FastGDRomLoad", false);
 
@@ -251,6 +259,7 @@ Option<bool> OmxAudioHdmi("audio_hdmi", true, "omx");
 
 Option<int> MouseSensitivity("MouseSensitivity", 100, "input");
 Option<int> VirtualGamepadVibration("VirtualGamepadVibration", 20, "input");
+Option<bool> JitInputPolling("JitInputPolling", false, "input");
 
 std::array<Option<MapleDeviceType>, 4> MapleMainDevices {
 	Option<MapleDeviceType>("device1", MDT_SegaController, "input"),
@@ -277,6 +286,7 @@ Option<bool, false> UseRawInput("RawInput", false, "input");
 
 #ifdef USE_LUA
 Option<std::string, false> LuaFileName("LuaFileName", "flycast.lua");
+Option<bool, false> LuaAsyncVBlank("LuaAsyncVBlank", false);
 #endif
 
 } // namespace config
@@ -383,6 +383,9 @@ extern Option<bool> LimitFPS;
 extern Option<bool> DSPEnabled;
 extern Option<int> AudioBufferSize;	//In samples ,*4 for bytes
 extern Option<bool> AutoLatency;
+extern Option<bool> ThreadedSoundCpu;
+extern Option<bool> AudioRingBuffer;
+extern Option<int> AudioRingLatency;	// In samples
 
 extern OptionString AudioBackend;
 
@@ -444,6 +447,7 @@ constexpr bool Clipping = true;
 #ifndef LIBRETRO
 extern Option<int> TextureUpscale;
 extern Option<int> MaxFilteredTextureSize;
+extern Option<bool> BackgroundTextureUpscaling;
 extern Option<int> PerPixelLayers;
 #endif
 extern Option<float> ExtraDepthScale;
@@ -452,6 +456,7 @@ extern Option<bool> DumpTextures;
 extern Option<int> ScreenStretching;	// in percent. 150 means stretch from 4/3 to 6/3
 extern Option<bool> Fog;
 extern Option<bool> FloatVMUs;
+extern Option<bool> ShowFrameTiming;
 extern Option<bool> Rotate90;
 extern Option<bool> PerStripSorting;
 extern Option<bool> DelayFrameSwapping;	// Delay swapping frame until FB_R_SOF matches FB_W_SOF
@@ -472,6 +477,7 @@ extern Option<int> FixedFrequency; // 0: off, 1: auto, 2: 59.94Hz, 3: 60Hz, 4: 5
 extern Option<bool> FixedFrequencyThreadSleep;
 extern Option<bool> EmulateFramebuffer;
 extern Option<bool> FixUpscaleBleedingEdge;
+extern Option<int> RunAhead;	// Number of frames to run ahead. Requires single-threaded rendering
 
 // Misc
 
@@ -480,6 +486,8 @@ extern Option<bool> SerialPTY;
 extern Option<bool> GDB;
 extern Option<int> GDBPort;
 extern Option<bool> GDBWaitForConnection;
+extern Option<int> LatencyTest;	// Number of input latency samples to measure before exiting. 0: disabled
+extern Option<int> SH4Profiler;	// SH4 sampling profiler frequency in Hz. 0: disabled
 extern Option<bool> UseReios;
 extern Option<bool> FastGDRomLoad;
 
@@ -612,6 +620,7 @@ extern Option<bool> CustomOutputStreamTxt;
 
 extern Option<int> MouseSensitivity;
 extern Option<int> VirtualGamepadVibration;
+extern Option<bool> JitInputPolling;	// Poll input devices when the game reads the controllers
 extern std::array<Option<MapleDeviceType>, 4> MapleMainDevices;
 extern std::array<std::array<Option<MapleDeviceType>, 2>, 4> MapleExpansionDevices;
 #ifdef _WIN32
@@ -622,6 +631,7 @@ constexpr bool UseRawInput = false;
 
 #ifdef USE_LUA
 extern Option<std::string, false> LuaFileName;
+extern Option<bool, false> LuaAsyncVBlank;
 #endif
 
 } // namespace config
@@ -0,0 +1,160 @@
+#include "cheat_search.h"
+#include "hw/sh4/sh4_mem.h"
+#include "log/BitSet.h"
+
+#include <cstring>
+
+CheatSearch cheatSearch;
+
+void CheatSearch::start(ValueType type)
+{
+	start(type, mem_b.data, RAM_SIZE);
+}
+
+void CheatSearch::start(ValueType type, const u8 *ram, u32 size)
+{
+	this->type = type;
+	const u32 values = size / valueSize();
+	// Values are processed by blocks of 64
+	verify(values % 64 == 0);
+	candidates.assign(values / 64, ~0ull);
+	count = values;
+	snapshot.assign(ram, ram + size);
+}
+
+void CheatSearch::search(Condition condition, u32 value)
+{
+	if (snapshot.size() != RAM_SIZE)
+	{
+		// Started with another platform
+		reset();
+		return;
+	}
+	search(condition, value, mem_b.data);
+}
+
+void CheatSearch::search(Condition condition, u32 value, const u8 *ram)
+{
+	if (!started())
+		return;
+	switch (type)
+	{
+	case ValueType::Int8:
+		filter<u8>(condition, (u8)value, ram);
+		break;
+	case ValueType::Int16:
+		filter<u16>(condition, (u16)value, ram);
+		break;
+	case ValueType::Int32:
+		filter<u32>(condition, value, ram);
+		break;
+	case ValueType::Float:
+		{
+			f32 f;
+			memcpy(&f, &value, sizeof(f));
+			filter<f32>(condition, f, ram);
+		}
+		break;
+	}
+}
+
+// Compare a block of 64 values and return the result as a bitmap.
+// The comparison loop is branchless so that the compiler can vectorize it.
+template<typename T, typename Compare>
+static u64 compareBlock(const T *cur, const T *prev, Compare compare)
+{
+	u8 flags[64];
+	for (int i = 0; i < 64; i++)
+		flags[i] = compare(cur[i], prev[i]);
+	// Pack 8 flags at a time into a byte
+	u64 match = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		u64 v;
+		memcpy(&v, &flags[i * 8], sizeof(v));
+		match |= ((v * 0x0102040810204080ull) >> 56) << (i * 8);
+	}
+	return match;
+}
+
+template<typename T>
+void CheatSearch::filter(Condition condition, T value, const u8 *ram)
+{
+	const T *cur = (const T *)ram;
+	T *prev = (T *)snapshot.data();
+	count = 0;
+	for (size_t block = 0; block < candidates.size(); block++, cur += 64, prev += 64)
+	{
+		u64 mask = candidates[block];
+		if (mask == 0)
+			continue;
+		switch (condition)
+		{
+		case Condition::Equal:
+			mask &= compareBlock(cur, prev, [value](T c, T p) { return c == value; });
+			break;
+		case Condition::Changed:
+			mask &= compareBlock(cur, prev, [](T c, T p) { return c != p; });
+			break;
+		case Condition::Unchanged:
+			mask &= compareBlock(cur, prev, [](T c, T p) { return c == p; });
+			break;
+		case Condition::Increased:
+			mask &= compareBlock(cur, prev, [](T c, T p) { return c > p; });
+			break;
+		case Condition::Decreased:
+			mask &= compareBlock(cur, prev, [](T c, T p) { return c < p; });
+			break;
+		}
+		candidates[block] = mask;
+		if (mask != 0)
+		{
+			// Only the values of the remaining candidates need to be kept
+			memcpy(prev, cur, sizeof(T) * 64);
+			count += Common::CountSetBits(mask);
+		}
+	}
+}
+
+void CheatSearch::reset()
+{
+	candidates.clear();
+	snapshot.clear();
+	count = 0;
+}
+
+std::vector<u32> CheatSearch::results(size_t maxCount) const
+{
+	std::vector<u32> addresses;
+	for (size_t block = 0; block < candidates.size() && addresses.size() < maxCount; block++)
+	{
+		u64 mask = candidates[block];
+		while (mask != 0 && addresses.size() < maxCount)
+		{
+			int bit = Common::LeastSignificantSetBit(mask);
+			addresses.push_back((u32)(block * 64 + bit) * valueSize());
+			mask &= mask - 1;
+		}
+	}
+	return addresses;
+}
+
+u32 CheatSearch::previousValue(u32 address) const
+{
+	if (address + valueSize() > snapshot.size())
+		return 0;
+	switch (type)
+	{
+	case ValueType::Int8:
+		return snapshot[address];
+	case ValueType::Int16:
+		return *(const u16 *)&snapshot[address];
+	default:
+		return *(const u32 *)&snapshot[address];
+	}
+}
+
+Cheat CheatSearch::makeCheat(const std::string& description, u32 address, u32 value) const
+{
+	return Cheat(Cheat::Type::setValue, description, true, valueSize() * 8, address, value);
+}
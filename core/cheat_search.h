@@ -0,0 +1,56 @@
+#pragma once
+#include "types.h"
+#include "cheats.h"
+
+#include <vector>
+
+// Multi-pass search of system RAM values, used to find cheat addresses.
+// Candidates are kept in a bitmap with one bit per aligned value.
+class CheatSearch
+{
+public:
+	enum class ValueType {
+		Int8,
+		Int16,
+		Int32,
+		Float
+	};
+	enum class Condition {
+		Equal,		// equal to the given value
+		Changed,	// different from the previous search
+		Unchanged,
+		Increased,
+		Decreased
+	};
+
+	// Start a new search: all aligned addresses are candidates
+	void start(ValueType type);
+	void start(ValueType type, const u8 *ram, u32 size);
+	// Keep the candidates matching the condition. The value is only used with Condition::Equal
+	// and holds the bit pattern of the float for ValueType::Float.
+	void search(Condition condition, u32 value = 0);
+	void search(Condition condition, u32 value, const u8 *ram);
+	void reset();
+
+	bool started() const { return !candidates.empty(); }
+	ValueType valueType() const { return type; }
+	size_t candidateCount() const { return count; }
+	// Returns the address (RAM offset) of the first maxCount candidates
+	std::vector<u32> results(size_t maxCount) const;
+	// Value at the given address when the last search was done
+	u32 previousValue(u32 address) const;
+	// Returns a cheat that sets the given address to the given value
+	Cheat makeCheat(const std::string& description, u32 address, u32 value) const;
+
+private:
+	u32 valueSize() const { return type == ValueType::Int8 ? 1 : type == ValueType::Int16 ? 2 : 4; }
+	template<typename T>
+	void filter(Condition condition, T value, const u8 *ram);
+
+	ValueType type = ValueType::Int32;
+	std::vector<u64> candidates;
+	std::vector<u8> snapshot;
+	size_t count = 0;
+};
+
+extern CheatSearch cheatSearch;
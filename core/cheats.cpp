@@ -359,6 +359,7 @@ static void vblankCallback(Event event, void *param)
 void CheatManager::setActive(bool active)
 {
 	this->active = active;
+	compiled = false;
 	if (active || widescreen_cheat != nullptr)
 		EventManager::listen(Event::VBlank, vblankCallback, this);
 	else
@@ -571,74 +572,182 @@ void CheatManager::apply()
 	}
 	if (active && !settings.network.online)
 	{
-		bool skipCheat = false;
-		for (const Cheat& cheat : cheats)
+		if (!compiled)
+			compile();
+		run();
+	}
+}
+
+void CheatManager::compile()
+{
+	// A condition only applies to the next cheat, so it is useless if the next cheat does nothing.
+	// Find which cheats have an effect, starting from the end.
+	std::vector<bool> used(cheats.size() + 1, false);
+	for (int i = (int)cheats.size() - 1; i >= 0; i--)
+	{
+		const Cheat& cheat = cheats[i];
+		used[i] = cheat.enabled && cheat.type != Cheat::Type::disabled;
+		if (cheat.type >= Cheat::Type::runNextIfEq && cheat.type <= Cheat::Type::runNextIfLt)
+			used[i] = used[i] && used[i + 1];
+	}
+	program.clear();
+	for (size_t i = 0; i < cheats.size(); i++)
+	{
+		const Cheat& cheat = cheats[i];
+		if (!used[i])
+			continue;
+		Operation op{};
+		op.width = cheat.size <= 8 ? 1 : cheat.size / 8;
+		op.keepMask = cheat.size < 8 ? ~cheat.valueMask : 0;
+		op.offset = cheat.address;
+		op.value = cheat.value;
+		op.count = cheat.repeatCount;
+		op.valueIncrement = cheat.repeatValueIncrement;
+		op.offsetIncrement = cheat.repeatAddressIncrement * cheat.size / 8;
+		switch (cheat.type)
 		{
-			if (skipCheat) {
-				skipCheat = false;
-				continue;
-			}
-			if (!cheat.enabled)
-				continue;
+		case Cheat::Type::setValue:
+			op.opcode = Operation::Set;
+			break;
+		case Cheat::Type::increase:
+			op.opcode = Operation::Add;
+			break;
+		case Cheat::Type::decrease:
+			op.opcode = Operation::Add;
+			op.value = 0u - cheat.value;
+			break;
+		case Cheat::Type::runNextIfEq:
+			op.opcode = Operation::SkipIfNeq;
+			break;
+		case Cheat::Type::runNextIfNeq:
+			op.opcode = Operation::SkipIfEq;
+			break;
+		case Cheat::Type::runNextIfGt:
+			op.opcode = Operation::SkipIfLe;
+			break;
+		case Cheat::Type::runNextIfLt:
+			op.opcode = Operation::SkipIfGe;
+			break;
+		case Cheat::Type::copy:
+			op.opcode = Operation::Copy;
+			op.value = cheat.destAddress;
+			break;
+		case Cheat::Type::disabled:
+		default:
+			continue;
+		}
+		program.push_back(op);
+	}
+	compiled = true;
+	DEBUG_LOG(COMMON, "%d cheats compiled into %d operations", (int)cheats.size(), (int)program.size());
+}
+
+static u32 readHost(const u8 *p, u32 width)
+{
+	switch (width)
+	{
+	case 1:
+	default:
+		return *p;
+	case 2:
+		{
+			u16 v;
+			memcpy(&v, p, sizeof(v));
+			return v;
+		}
+	case 4:
+		{
+			u32 v;
+			memcpy(&v, p, sizeof(v));
+			return v;
+		}
+	}
+}
+
+static void writeHost(u8 *p, u32 value, u32 width)
+{
+	switch (width)
+	{
+	case 1:
+	default:
+		*p = (u8)value;
+		break;
+	case 2:
+		{
+			u16 v = (u16)value;
+			memcpy(p, &v, sizeof(v));
+		}
+		break;
+	case 4:
+		memcpy(p, &value, sizeof(value));
+		break;
+	}
+}
+
+void CheatManager::run()
+{
+	u8 * const ram = mem_b.data;
+	const u32 ramMask = RAM_MASK;
+	const u32 ramSize = RAM_SIZE;
+	// Returns a host pointer to the given RAM offset, or nullptr if the access overflows
+	const auto hostPtr = [ram, ramMask, ramSize](u32 offset, u32 width) -> u8 * {
+		offset &= ramMask;
+		return offset + width <= ramSize ? ram + offset : nullptr;
+	};
 
-			bool setValue = false;
-			u32 valueToSet = 0;
-			switch (cheat.type)
+	for (size_t pc = 0; pc < program.size(); pc++)
+	{
+		const Operation& op = program[pc];
+		const u8 *p = hostPtr(op.offset, op.width);
+		if (p == nullptr)
+			continue;
+		const u32 curVal = readHost(p, op.width);
+		u32 valueToSet;
+		switch (op.opcode)
+		{
+		case Operation::SkipIfNeq:
+			pc += curVal != op.value;
+			continue;
+		case Operation::SkipIfEq:
+			pc += curVal == op.value;
+			continue;
+		case Operation::SkipIfLe:
+			pc += curVal <= op.value;
+			continue;
+		case Operation::SkipIfGe:
+			pc += curVal >= op.value;
+			continue;
+		case Operation::Copy:
+			for (u32 i = 0; i < op.count; i++)
 			{
-			case Cheat::Type::disabled:
-			default:
-				break;
-			case Cheat::Type::setValue:
-				setValue = true;
-				valueToSet = cheat.value;
-				break;
-			case Cheat::Type::increase:
-				setValue = true;
-				valueToSet = readRam(cheat.address, cheat.size) + cheat.value;
-				break;
-			case Cheat::Type::decrease:
-				setValue = true;
-				valueToSet = readRam(cheat.address, cheat.size) - cheat.value;
-				break;
-			case Cheat::Type::runNextIfEq:
-				skipCheat = readRam(cheat.address, cheat.size) != cheat.value;
-				break;
-			case Cheat::Type::runNextIfNeq:
-				skipCheat = readRam(cheat.address, cheat.size) == cheat.value;
-				break;
-			case Cheat::Type::runNextIfGt:
-				skipCheat = readRam(cheat.address, cheat.size) <= cheat.value;
-				break;
-			case Cheat::Type::runNextIfLt:
-				skipCheat = readRam(cheat.address, cheat.size) >= cheat.value;
-				break;
-			case Cheat::Type::copy:
-				for (u32 i = 0; i < cheat.repeatCount; i++)
-					writeRam(cheat.destAddress + i, readRam(cheat.address + i, cheat.size), cheat.size);
-				break;
+				const u8 *src = hostPtr(op.offset + i, op.width);
+				u8 *dst = hostPtr(op.value + i, op.width);
+				if (src != nullptr && dst != nullptr)
+					writeHost(dst, readHost(src, op.width), op.width);
 			}
-			if (setValue)
+			continue;
+		case Operation::Set:
+			valueToSet = op.value;
+			break;
+		case Operation::Add:
+		default:
+			valueToSet = curVal + op.value;
+			break;
+		}
+		const u32 widthMask = op.width == 4 ? 0xffffffff : (1 << (op.width * 8)) - 1;
+		u32 offset = op.offset;
+		for (u32 repeat = 0; repeat < op.count; repeat++)
+		{
+			u8 *dst = hostPtr(offset, op.width);
+			if (dst != nullptr)
 			{
-				u32 address = cheat.address;
-				for (u32 repeat = 0; repeat < cheat.repeatCount; repeat++)
-				{
-					u32 curVal = readRam(address, cheat.size);
-					if (cheat.size < 8)
-					{
-						for (int i = 0; i < 8; i++)
-						{
-							int bitmask = 1 << i;
-							if ((cheat.valueMask & bitmask) == 0)
-								// keep current bit value
-								valueToSet = (valueToSet & ~bitmask) | (curVal & bitmask);
-						}
-					}
-					if (curVal != valueToSet)
-						writeRam(address, valueToSet, cheat.size);
-					address += cheat.repeatAddressIncrement * cheat.size / 8;
-					valueToSet += cheat.repeatValueIncrement;
-				}
+				const u32 cur = readHost(dst, op.width);
+				valueToSet = (valueToSet & ~op.keepMask) | (cur & op.keepMask);
+				if (cur != (valueToSet & widthMask))
+					writeHost(dst, valueToSet, op.width);
 			}
+			offset += op.offsetIncrement;
+			valueToSet += op.valueIncrement;
 		}
 	}
 }
@@ -863,15 +972,7 @@ void CheatManager::addGameSharkCheat(const std::string& name, const std::string&
 				throw FlycastException("Unsupported cheat type");
 			}
 		}
-#ifndef LIBRETRO
-		std::string path = cfgLoadStr("cheats", gameId, "");
-		if (path == "")
-		{
-			path = get_game_save_prefix() + ".cht";
-			cfgSaveStr("cheats", gameId, path);
-		}
-		saveCheatFile(path);
-#endif
+		saveGameCheats();
 		setActive(!cheats.empty());
 	} catch (...) {
 		cheats.erase(cheats.begin() + prevSize, cheats.end());
@@ -879,6 +980,26 @@ void CheatManager::addGameSharkCheat(const std::string& name, const std::string&
 	}
 }
 
+void CheatManager::addCheat(const Cheat& cheat)
+{
+	cheats.push_back(cheat);
+	saveGameCheats();
+	setActive(true);
+}
+
+void CheatManager::saveGameCheats()
+{
+#ifndef LIBRETRO
+	std::string path = cfgLoadStr("cheats", gameId, "");
+	if (path == "")
+	{
+		path = get_game_save_prefix() + ".cht";
+		cfgSaveStr("cheats", gameId, path);
+	}
+	saveCheatFile(path);
+#endif
+}
+
 void CheatManager::saveCheatFile(const std::string& filename)
 {
 #ifndef LIBRETRO
@@ -75,24 +75,56 @@ public:
 	size_t cheatCount() const { return cheats.size(); }
 	const std::string& cheatDescription(size_t index) const { return cheats[index].description; }
 	bool cheatEnabled(size_t index) const { return cheats[index].enabled; }
-	void enableCheat(size_t index, bool enabled) { cheats[index].enabled = enabled; }
+	void enableCheat(size_t index, bool enabled) {
+		cheats[index].enabled = enabled;
+		compiled = false;
+	}
 	int enabledCheatCount();
 	void loadCheatFile(const std::string& filename);
 	void saveCheatFile(const std::string& filename);
 	// Returns true if using 16:9 anamorphic screen ratio
 	bool isWidescreen() const { return widescreen_cheat != nullptr; }
 	void addGameSharkCheat(const std::string& name, const std::string& s);
+	void addCheat(const Cheat& cheat);
 
 private:
 	u32 readRam(u32 addr, u32 bits);
 	void writeRam(u32 addr, u32 value, u32 bits);
 	void setActive(bool active);
+	void saveGameCheats();
+	void compile();
+	void run();
+
+	// Enabled cheats are compiled into a flat list of operations on RAM offsets
+	// so that applying them doesn't need to go through the memory handlers.
+	struct Operation
+	{
+		enum Opcode : u8 {
+			Set,
+			Add,
+			SkipIfNeq,	// skip the next operation if the value is different
+			SkipIfEq,
+			SkipIfLe,
+			SkipIfGe,
+			Copy
+		};
+		Opcode opcode;
+		u8 width;		// access size in bytes
+		u8 keepMask;	// bits of the current value to keep when patching less than 8 bits
+		u32 offset;
+		u32 value;		// or destination offset for Copy
+		u32 count;
+		u32 valueIncrement;
+		u32 offsetIncrement;
+	};
 
 	static const WidescreenCheat widescreen_cheats[];
 	static const WidescreenCheat naomi_widescreen_cheats[];
 	const WidescreenCheat *widescreen_cheat = nullptr;
 	bool active = false;
 	std::vector<Cheat> cheats;
+	std::vector<Operation> program;
+	bool compiled = false;
 	std::string gameId;
 
 	friend class CheatManagerTest_TestLoad_Test;
@@ -23,6 +23,7 @@
 #include "hw/sh4/sh4_mem.h"
 #include "hw/sh4/sh4_interpreter.h"
 #include "cfg/option.h"
+#include "hw/mem/mem_watch.h"
 #include <array>
 #include <signal.h>
 #include <map>
@@ -78,13 +79,17 @@ class DebugAgent
 public:
 	void doContinue(u32 pc = 1)
 	{
+		watchAddress = 0;
 		if (pc != 1)
 			Sh4cntx.pc = pc;
+		// pages may have been unprotected by a reset
+		memwatch::watchpoints.protect();
 		emu.start();
 	}
 
 	void step()
 	{
+		watchAddress = 0;
 		bool restoreBreakpoint = removeMatchpoint(Breakpoint::Type::BP_TYPE_SOFTWARE_BREAK, Sh4cntx.pc, 2);
 		u32 savedPc = Sh4cntx.pc;
 		emu.step();
@@ -94,6 +99,7 @@ public:
 
 	void stepRange(u32 from, u32 to)
 	{
+		watchAddress = 0;
 		bool restoreBreakpoint = removeMatchpoint(Breakpoint::Type::BP_TYPE_SOFTWARE_BREAK, Sh4cntx.pc, 2);
 		u32 savedPc = Sh4cntx.pc;
 		emu.stepRange(from, to);
@@ -176,6 +182,7 @@ public:
 	}
 	void writeMem(u32 addr, const std::vector<u8>& data)
 	{
+		memwatch::watchpoints.suspend();
 		const u8 *p = &data[0];
 		u32 len = data.size();
 		while (len > 0)
@@ -201,9 +208,12 @@ public:
 				len--;
 			}
 		}
+		memwatch::watchpoints.resume();
 	}
 	bool insertMatchpoint(char type, u32 addr, u32 len)
 	{
+		if (type == Breakpoint::Type::BP_TYPE_WRITE_WATCHPOINT)
+			return memwatch::watchpoints.add(addr, len);
 		if (type == 0 && len != 2) {
 			WARN_LOG(COMMON, "insertMatchpoint: length != 2: %d", len);
 			return false;
@@ -213,11 +223,15 @@ public:
 			return true;
 		breakpoints[type][addr] = Breakpoint(type, addr);
 		breakpoints[type][addr].savedOp = ReadMem16_nommu(addr);
+		memwatch::watchpoints.suspend();
 		WriteMem16_nommu(addr, 0xC308);	// trapa #0x20
+		memwatch::watchpoints.resume();
 		return true;
 	}
 	bool removeMatchpoint(char type, u32 addr, u32 len)
 	{
+		if (type == Breakpoint::Type::BP_TYPE_WRITE_WATCHPOINT)
+			return memwatch::watchpoints.remove(addr, len);
 		if (type == 0 && len != 2) {
 			WARN_LOG(COMMON, "removeMatchpoint: length != 2: %d", len);
 			return false;
@@ -225,7 +239,9 @@ public:
 		auto it = breakpoints[type].find(addr);
 		if (it == breakpoints[type].end())
 			return false;
+		memwatch::watchpoints.suspend();
 		WriteMem16_nommu(addr, it->second.savedOp);
+		memwatch::watchpoints.resume();
 		breakpoints[type].erase(it);
 		return true;
 	}
@@ -245,6 +261,13 @@ public:
 		Sh4cntx.pc -= 2;	// FIXME delay slot
 	}
 
+	// called on the emu thread when a watched RAM range has been written to
+	void watchpointTrap(u32 addr)
+	{
+		exception = SIGTRAP;
+		watchAddress = addr;
+	}
+
 	void postDebugTrap()
 	{
 		// needed to join the emu thread since debugTrap() is called by it
@@ -265,9 +288,23 @@ public:
 
 	void detach()
 	{
+		memwatch::watchpoints.clear();
 		emu.start();
 	}
 
+	// Unprotect the watched pages when the debugger goes away
+	void clearWatchpoints()
+	{
+		if (memwatch::watchpoints.empty())
+			return;
+		const bool running = emu.running();
+		if (running)
+			emu.stop();
+		memwatch::watchpoints.clear();
+		if (running)
+			emu.start();
+	}
+
 	void kill()
 	{
 		dc_exit();
@@ -326,6 +363,8 @@ public:
 	}
 
 	u32 exception = 0;
+	// Address of the write watchpoint that stopped the cpu, if any
+	u32 watchAddress = 0;
 
 	struct Breakpoint {
 		enum Type
@@ -82,6 +82,7 @@ public:
 		EventManager::unlisten(Event::Resume, emuEventCallback);
 		EventManager::unlisten(Event::Terminate, emuEventCallback);
 		stop();
+		agent.clearWatchpoints();
 		if (VALID(clientSocket))
 		{
 			closesocket(clientSocket);
@@ -135,6 +136,18 @@ public:
 		throw Stop();
 	}
 
+	// called on the emu thread
+	void watchpointHit(u32 addr)
+	{
+		// Stopping is only supported by the interpreter, which is always used when gdb is attached
+		if (!attached || addr == 0 || config::DynarecEnabled)
+			return;
+		agent.watchpointTrap(addr);
+		reportException();
+		postDebugTrapNeeded = true;
+		throw Stop();
+	}
+
 private:
 	const u32 EXCEPT_NONE = 1;
 
@@ -178,6 +191,7 @@ private:
 			closesocket(clientSocket);
 			clientSocket = INVALID_SOCKET;
 		}
+		agent.clearWatchpoints();
 		attached = false;
 		stopRequested = false;
 	}
@@ -321,13 +335,17 @@ private:
 			closesocket(clientSocket);
 			clientSocket = INVALID_SOCKET;
 			attached = false;
+			agent.clearWatchpoints();
 		}
 	}
 
 	void reportException()
 	{
-		char s[4];
-		sprintf(s, "S%02X", agent.currentException());
+		char s[32];
+		if (agent.watchAddress != 0)
+			sprintf(s, "T%02Xwatch:%08x;", agent.currentException(), agent.watchAddress);
+		else
+			sprintf(s, "S%02X", agent.currentException());
 		sendPacket(s);
 	}
 
@@ -683,9 +701,10 @@ private:
 		u32 type;
 		u32 addr;
 		u32 len;
-		if (sscanf(pkt.c_str(), "Z%1d,%x,%1d", &type, &addr, &len) != 3) {
+		if (sscanf(pkt.c_str(), "Z%1d,%x,%x", &type, &addr, &len) != 3) {
 			WARN_LOG(COMMON, "insertMatchpoint: unknown packet: %s", pkt.c_str());
 			sendPacket("E01");
+			return;
 		}
 		switch (type) {
 			case DebugAgent::Breakpoint::Type::BP_TYPE_SOFTWARE_BREAK:		// soft bp
@@ -698,7 +717,10 @@ private:
 		    	sendPacket("");
 		    	break;
 		    case DebugAgent::Breakpoint::Type::BP_TYPE_WRITE_WATCHPOINT:	// write watchpoint
-		    	sendPacket("");
+		    	if (agent.insertMatchpoint(type, addr, len))
+		    		sendPacket("OK");
+		    	else
+		    		sendPacket("E01");
 		    	break;
 		    case DebugAgent::Breakpoint::Type::BP_TYPE_READ_WATCHPOINT:		// read watchpoint
 		    	sendPacket("");
@@ -717,9 +739,10 @@ private:
 		u32 type;
 		u32 addr;
 		u32 len;
-		if (sscanf(pkt.c_str(), "z%1d,%x,%1d", &type, &addr, &len) != 3) {
+		if (sscanf(pkt.c_str(), "z%1d,%x,%x", &type, &addr, &len) != 3) {
 			WARN_LOG(COMMON, "removeMatchpoint: unknown packet: %s", pkt.c_str());
 			sendPacket("E01");
+			return;
 		}
 		switch (type) {
 		    case 0:		// soft bp
@@ -732,7 +755,10 @@ private:
 		    	sendPacket("");
 		    	break;
 		    case 2:		// write watchpoint
-		    	sendPacket("");
+		    	if (agent.removeMatchpoint(type, addr, len))
+		    		sendPacket("OK");
+		    	else
+		    		sendPacket("E01");
 		    	break;
 		    case 3:		// read watchpoint
 		    	sendPacket("");
@@ -917,6 +943,11 @@ void debugTrap(u32 event)
 	gdbServer.debugTrap(event);
 }
 
+void watchpointHit(u32 addr)
+{
+	gdbServer.watchpointHit(addr);
+}
+
 void subroutineCall()
 {
 	gdbServer.agent.subroutineCall();
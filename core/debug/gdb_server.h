@@ -31,6 +31,7 @@ struct Stop { };
 	void term();
 	void run();
 	void debugTrap(u32 event);
+	void watchpointHit(u32 addr);
 	void subroutineCall();
 	void subroutineReturn();
 
@@ -39,6 +40,7 @@ struct Stop { };
 	static inline void term() {}
 	static inline void run() {}
 	static inline void debugTrap(u32 event) {}
+	static inline void watchpointHit(u32 addr) {}
 	static inline void subroutineCall() {}
 	static inline void subroutineReturn() {}
 #endif
@@ -573,6 +573,8 @@ u16 DojoSession::ApplyNetInputs(PlainJoystickState* pjs, u16 buttons, u32 port)
 					if (config::EnableSessionQuickLoad)
 					{
 						dc_savestate(net_save_path);
+						// the file is checked and advertised to the opponent right away
+						dc_waitSavestate();
 					}
 				}
 			}
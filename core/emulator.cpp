@@ -30,6 +30,7 @@
 #include "hw/sh4/sh4_sched.h"
 #include "hw/holly/sb_mem.h"
 #include "cheats.h"
+#include "cheat_search.h"
 #include "oslib/audiostream.h"
 #include "debug/gdb_server.h"
 #include "hw/pvr/Renderer_if.h"
@@ -42,6 +43,8 @@
 #include "serialize.h"
 #include "hw/pvr/pvr.h"
 #include "profiler/fc_profiler.h"
+#include "profiler/latency.h"
+#include "profiler/sh4_sampler.h"
 #include <chrono>
 
 #include "dojo/DojoSession.hpp"
@@ -604,6 +607,7 @@ void Emulator::loadGame(const char *path, LoadProgress *progress)
 			// Must be done after the maple devices are created and EEPROM is accessible
 			naomi_cart_ConfigureEEPROM();
 		cheatManager.reset(settings.content.gameId);
+		cheatSearch.reset();
 		if (cheatManager.isWidescreen())
 		{
 			gui_display_notification("Widescreen cheat activated", 1000);
@@ -667,17 +671,10 @@ void Emulator::runInternal()
 	}
 	else
 	{
-		do {
-			resetRequested = false;
-
-			sh4_cpu.Run();
-
-			if (resetRequested)
-			{
-				SaveRomFiles();
-				dc_reset(false);
-			}
-		} while (resetRequested);
+		if (runAheadEnabled())
+			runAhead();
+		else
+			runFrame();
 
 		if (!config::ThreadedRendering)
 		{
@@ -691,13 +688,129 @@ void Emulator::runInternal()
 	}
 }
 
+// Returns true if the emulator has been reset
+bool Emulator::runFrame()
+{
+	bool reset = false;
+	do {
+		resetRequested = false;
+
+		sh4_cpu.Run();
+
+		if (resetRequested)
+		{
+			SaveRomFiles();
+			dc_reset(false);
+			reset = true;
+		}
+	} while (resetRequested);
+
+	return reset;
+}
+
+bool Emulator::runAheadEnabled() const
+{
+	// Frames must be emulated one at a time, and memory watching is already used by netplay rollbacks
+	return config::RunAhead > 0 && !config::ThreadedRendering
+			&& !config::GGPOEnable && !config::DojoEnable && !config::RecordMatches
+			&& !settings.network.online && !dojo.PlayMatch;
+}
+
+// Run-ahead: the current frame is emulated but not displayed and the state is saved.
+// The next frames are then emulated with the same inputs, without sound, and only the last one is displayed.
+// Finally the saved state is restored. This hides the input lag of games that take several frames to
+// react to inputs.
+// Only the memory pages modified since the state was saved are restored.
+void Emulator::runAhead()
+{
+	memwatch::runAhead = true;
+	hiddenFrame = true;
+	rend_enable_renderer(false);
+	bool reset = runFrame();
+	bool saved = false;
+	if (!reset && state == Running)
+	{
+		saveRunAheadState();
+		saved = true;
+		const bool muted = settings.aica.muteAudio;
+		settings.aica.muteAudio = true;
+		for (int i = 1; i <= config::RunAhead && !reset && state == Running; i++)
+		{
+			if (i == config::RunAhead)
+			{
+				hiddenFrame = false;
+				rend_enable_renderer(true);
+				renderTimeout = false;
+			}
+			startTime = sh4_sched_now64();
+			reset = runFrame();
+		}
+		settings.aica.muteAudio = muted;
+	}
+	hiddenFrame = false;
+	rend_enable_renderer(true);
+	if (reset)
+	{
+		// The saved state is no longer relevant
+		memwatch::unprotect();
+		memwatch::reset();
+	}
+	else if (saved)
+	{
+		loadRunAheadState();
+	}
+}
+
+void Emulator::stopRunAhead()
+{
+	memwatch::unprotect();
+	memwatch::reset();
+	memwatch::runAhead = false;
+	// Dynarec blocks and textures may rely on write protection that has been removed
+	sh4_cpu.ResetCache();
+	KillTex = true;
+}
+
+void Emulator::saveRunAheadState()
+{
+	Serializer ser(runAheadState.data(), runAheadState.size(), true);
+	dc_serialize(ser);
+	if (ser.overflow())
+	{
+		runAheadState.resize(ser.size());
+		ser = Serializer(runAheadState.data(), runAheadState.size(), true);
+		dc_serialize(ser);
+	}
+	runAheadStateSize = ser.size();
+	// Watch the memory pages written from now on
+	memwatch::discard();
+}
+
+void Emulator::loadRunAheadState()
+{
+	memwatch::restore();
+	Deserializer deser(runAheadState.data(), runAheadStateSize, true);
+	dc_deserialize(deser);
+}
+
+void Emulator::endOfFrame()
+{
+	// Stop at the end of each hidden run-ahead frame. Displayed frames stop when presented.
+	if (hiddenFrame)
+		sh4_cpu.Stop();
+}
+
 void Emulator::unloadGame()
 {
 	stop();
+	latency::term();
+	sampler::term();
+	memwatch::watchpoints.clear();
 	if (state == Loaded || state == Error)
 	{
 		if (state == Loaded && config::AutoSaveState && !settings.content.path.empty())
 			dc_savestate(config::SavestateSlot);
+		dc_waitSavestate();
 		dc_reset(true);
 
 		config::Settings::instance().reset();
@@ -757,6 +870,7 @@ void Emulator::stop()
 		// normally only useful on android due to multithreading
 		stopRequested = true;
 #else
+		sampler::stop();
 		TermAudio();
 		SaveRomFiles();
 		EventManager::event(Event::Pause);
@@ -938,13 +1052,17 @@ void Emulator::start()
 		INFO_LOG(DYNAREC, "Using Interpreter");
 	}
 
+	if (memwatch::runAhead && !runAheadEnabled())
+		stopRunAhead();
 	memwatch::protect();
+	latency::init();
 
 	if (config::ThreadedRendering)
 	{
 		const std::lock_guard<std::mutex> lock(mutex);
 		threadResult = std::async(std::launch::async, [this] {
 				InitAudio();
+				sampler::start();
 
 				try {
 					while (state == Running || singleStep || stepRangeTo != 0)
@@ -955,11 +1073,13 @@ void Emulator::start()
 						if (!ggpo::nextFrame())
 							break;
 					}
+					sampler::stop();
 					TermAudio();
 				} catch (...) {
 					setNetworkState(false);
 					state = Error;
 					sh4_cpu.Stop();
+					sampler::stop();
 					TermAudio();
 					throw;
 				}
@@ -969,6 +1089,7 @@ void Emulator::start()
 	{
 		stopRequested = false;
 		InitAudio();
+		sampler::start();
 	}
 
 	EventManager::event(Event::Resume);
@@ -1004,6 +1125,7 @@ bool Emulator::render()
 		if (stopRequested)
 		{
 			stopRequested = false;
+			sampler::stop();
 			TermAudio();
 			SaveRomFiles();
 			EventManager::event(Event::Pause);
@@ -38,6 +38,8 @@ void dc_exit();
 void dc_savestate(int index = 0);
 void dc_savestate(std::string filename);
 void dc_savestate(int index, std::string filename);
+// Wait for the pending savestate, if any, to be written to disk
+void dc_waitSavestate();
 void dc_loadstate(int index = 0);
 void dc_loadstate(std::string filename);
 void dc_loadstate(int index, std::string filename);
@@ -167,12 +169,22 @@ public:
 	 * Called internally on vblank.
 	 */
 	void vblank();
+	/**
+	 * Called internally when a frame is ready to be displayed.
+	 */
+	void endOfFrame();
 
 	void invoke_jump_state(bool dojo_invoke);
 
 private:
 	bool checkStatus();
 	void runInternal();
+	bool runFrame();
+	bool runAheadEnabled() const;
+	void runAhead();
+	void stopRunAhead();
+	void saveRunAheadState();
+	void loadRunAheadState();
 
 	enum State {
 		Uninitialized = 0,
@@ -193,6 +205,9 @@ private:
 	u32 stepRangeTo = 0;
 	bool stopRequested = false;
 	std::mutex mutex;
+	bool hiddenFrame = false;
+	std::vector<u8> runAheadState;
+	size_t runAheadStateSize = 0;
 };
 extern Emulator emu;
 
@@ -7,8 +7,15 @@
 #include "hw/sh4/sh4_sched.h"
 #include "hw/arm7/arm7.h"
 #include "hw/arm7/arm_mem.h"
+#include "hw/mem/mem_watch.h"
+#include "cfg/option.h"
+#include "stdclass.h"
+
+#include <atomic>
+#include <thread>
 
 #define SH4_IRQ_BIT (1 << (holly_SPU_IRQ & 31))
+constexpr u32 AICA_TICK_SAMPLES = 32;
 
 CommonData_struct* CommonData;
 DSPData_struct* DSPData;
@@ -66,9 +73,86 @@ static void update_arm_interrupts()
 	libARM_InterruptChange(p_ints,Lval);
 }
 
+//
+// Threaded sound cpu: the arm7 and sample generation of each AICA tick run on a separate thread while the SH4 keeps going.
+// The SH4 waits for the current block to complete before accessing the AICA registers, starting an AICA DMA
+// or starting the next block, so it is never more than one tick ahead of the sound cpu.
+// Wave memory is directly accessed by the SH4 without synchronization so this mode isn't deterministic
+// and is disabled during netplay.
+//
+static std::thread armThread;
+static std::atomic_bool armThreadRunning { false };
+static std::atomic_bool armBlockPending { false };
+static cResetEvent armBlockStart;
+static cResetEvent armBlockDone;
+static thread_local bool onArmThread;
+static std::atomic_bool sh4IntsPending { false };
+
+static void UpdateSh4Ints();
+
+static void armThreadMain()
+{
+	onArmThread = true;
+	while (true)
+	{
+		// Ignore spurious wake-ups
+		do {
+			armBlockStart.Wait();
+		} while (!armBlockPending && armThreadRunning);
+		if (!armThreadRunning)
+			break;
+		aicaarm::run(AICA_TICK_SAMPLES);
+		armBlockPending = false;
+		armBlockDone.Set();
+	}
+}
+
+void libAICA_Sync()
+{
+	if (onArmThread)
+		return;
+	while (armBlockPending)
+		armBlockDone.Wait();
+	// Interrupts raised by the sound cpu thread, even if its block is already done
+	if (sh4IntsPending && sh4IntsPending.exchange(false))
+		UpdateSh4Ints();
+}
+
+static bool useArmThread()
+{
+	return config::ThreadedSoundCpu && !config::GGPOEnable && !config::DojoEnable && !config::RecordMatches
+			&& !settings.network.online && !memwatch::runAhead;
+}
+
+static void startArmThread()
+{
+	if (armThreadRunning)
+		return;
+	armThreadRunning = true;
+	armThread = std::thread(armThreadMain);
+	INFO_LOG(AICA_ARM, "Sound cpu thread started");
+}
+
+static void stopArmThread()
+{
+	if (!armThreadRunning)
+		return;
+	libAICA_Sync();
+	armThreadRunning = false;
+	armBlockStart.Set();
+	armThread.join();
+	INFO_LOG(AICA_ARM, "Sound cpu thread stopped");
+}
+
 //sh4 side
 static void UpdateSh4Ints()
 {
+	if (onArmThread)
+	{
+		// Only the emulation thread can raise SH4 interrupts
+		sh4IntsPending = true;
+		return;
+	}
 	u32 p_ints = MCIEB->full & MCIPD->full;
 	if (p_ints)
 	{
@@ -89,7 +173,19 @@ const int AICA_TICK = 145125;	// 44.1 KHz / 32
 
 static int AicaUpdate(int tag, int c, int j)
 {
-	aicaarm::run(32);
+	libAICA_Sync();
+	if (useArmThread())
+	{
+		startArmThread();
+		AICA_PrefetchCDDA(AICA_TICK_SAMPLES);
+		armBlockPending = true;
+		armBlockStart.Set();
+	}
+	else
+	{
+		stopArmThread();
+		aicaarm::run(AICA_TICK_SAMPLES);
+	}
 
 	return AICA_TICK;
 }
@@ -111,6 +207,24 @@ void libAICA_TimeStep()
 	UpdateSh4Ints();	
 }
 
+// Used when the arm7 is stopped: registers can only be written by the sh4 between two scheduler events
+// so a whole block of samples can be generated at once.
+void libAICA_TimeStepBlock(u32 samples)
+{
+	if (samples == 0)
+		return;
+	for (int i=0;i<3;i++)
+		timers[i].StepTimer(samples);
+
+	SCIPD->SAMPLE_DONE = 1;
+	MCIPD->SAMPLE_DONE = 1;
+
+	AICA_SampleBlock(samples);
+
+	update_arm_interrupts();
+	UpdateSh4Ints();
+}
+
 static void AicaInternalDMA()
 {
 	if (!CommonData->DEXE)
@@ -230,6 +344,7 @@ template void WriteAicaReg<>(u32 reg, u32 data);
 
 void aica_midiSend(u8 data)
 {
+	libAICA_Sync();
 	midiSendBuffer.push_back(data);
 	SCIPD->MIDI_IN = 1;
 	update_arm_interrupts();
@@ -267,6 +382,7 @@ s32 libAICA_Init()
 
 void libAICA_Reset(bool hard)
 {
+	libAICA_Sync();
 	if (hard)
 	{
 		init_mem();
@@ -280,6 +396,7 @@ void libAICA_Reset(bool hard)
 
 void libAICA_Term()
 {
+	stopArmThread();
 	sgc_Term();
 	term_mem();
 	sh4_sched_unregister(aica_schid);
@@ -24,3 +24,6 @@ s32 libAICA_Init();
 void libAICA_Reset(bool hard);
 void libAICA_Term();
 void libAICA_TimeStep();
+void libAICA_TimeStepBlock(u32 samples);
+// Wait for the sound cpu thread to complete its current block. Must be called before the SH4 accesses the AICA.
+void libAICA_Sync();
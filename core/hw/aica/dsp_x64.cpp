@@ -22,6 +22,8 @@
 #if HOST_CPU == CPU_X64 && FEAT_DSPREC != DYNAREC_NONE
 
 #include <xbyak/xbyak.h>
+#include <xxhash.h>
+#include <unordered_map>
 #include "dsp.h"
 #include "aica.h"
 #include "aica_if.h"
@@ -30,7 +32,9 @@
 namespace dsp
 {
 
-constexpr size_t CodeBufferSize = 32 * 1024;
+// Worst case size of a compiled program
+constexpr size_t MaxProgramSize = 32 * 1024;
+constexpr size_t CodeBufferSize = 8 * MaxProgramSize;
 #if defined(_WIN32)
 static u8 *CodeBuffer;
 #else
@@ -47,6 +51,19 @@ alignas(4096) static u8 CodeBuffer[CodeBufferSize]
 #endif
 static u8 *pCodeBuffer;
 static ptrdiff_t rx_offset;
+static size_t codeBufferUsed;
+static u8 *programCode;		// current program entry point
+
+// Compiled programs are kept around so that games switching between effect programs don't need to recompile them.
+// The generated code depends on the program and on the ring buffer parameters.
+struct CachedProgram
+{
+	u32 mpro[128 * 4];
+	u32 rbl;
+	u32 rbp;
+	u8 *code;
+};
+static std::unordered_map<u64, CachedProgram> programCache;
 
 class X64DSPAssembler : public Xbyak::CodeGenerator
 {
@@ -414,10 +431,34 @@ private:
 
 void recompile()
 {
+	const u64 hash = XXH64(DSPData->MPRO, sizeof(DSPData->MPRO), ((u64)state.RBL << 32) | state.RBP);
+	auto it = programCache.find(hash);
+	if (it != programCache.end()
+			&& it->second.rbl == state.RBL && it->second.rbp == state.RBP
+			&& memcmp(it->second.mpro, DSPData->MPRO, sizeof(DSPData->MPRO)) == 0)
+	{
+		programCode = it->second.code;
+		return;
+	}
+	if (CodeBufferSize - codeBufferUsed < MaxProgramSize)
+	{
+		DEBUG_LOG(AICA_ARM, "DSP code buffer full: flushing %d programs", (int)programCache.size());
+		programCache.clear();
+		codeBufferUsed = 0;
+	}
 	vmem_platform_jit_set_exec(pCodeBuffer, CodeBufferSize, false);
-	X64DSPAssembler assembler(pCodeBuffer, CodeBufferSize);
+	X64DSPAssembler assembler(pCodeBuffer + codeBufferUsed, CodeBufferSize - codeBufferUsed);
 	assembler.Compile(&state);
 	vmem_platform_jit_set_exec(pCodeBuffer, CodeBufferSize, true);
+
+	programCode = pCodeBuffer + codeBufferUsed;
+	codeBufferUsed += (assembler.getSize() + 15) & ~15;
+
+	CachedProgram& program = programCache[hash];
+	memcpy(program.mpro, DSPData->MPRO, sizeof(DSPData->MPRO));
+	program.rbl = state.RBL;
+	program.rbp = state.RBP;
+	program.code = programCode;
 }
 
 void recInit()
@@ -428,11 +469,14 @@ void recInit()
 	if (!vmem_platform_prepare_jit_block(CodeBuffer, CodeBufferSize, (void**)&pCodeBuffer))
 #endif
 		die("vmem_platform_prepare_jit_block failed in x64 dsp");
+	programCache.clear();
+	codeBufferUsed = 0;
+	programCode = pCodeBuffer;
 }
 
 void runStep()
 {
-	((void (*)())&pCodeBuffer[0])();
+	((void (*)())programCode)();
 }
 
 }
@@ -568,6 +568,28 @@ struct ChannelEx
 			channel.Step(mixl, mixr);
 	}
 
+	// Generate a block of samples for this channel.
+	// Channel registers must not be written while the block is being generated.
+	void StepBlock(SampleType *mixl, SampleType *mixr, SampleType (*mixs)[16], u32 samples, bool dspEnabled)
+	{
+		if (!enabled)
+			return;
+		const u32 isel = (u32)(VolMix.DSPOut - &dsp::state.MIXS[0]);
+		for (u32 i = 0; i < samples; i++)
+		{
+			SampleType oLeft, oRight, oDsp;
+
+			Step(oLeft, oRight, oDsp);
+
+			mixs[i][isel] += oDsp;
+			if (oLeft + oRight == 0 && !dspEnabled)
+				oLeft = oRight = oDsp >> 4;
+
+			mixl[i] += oLeft;
+			mixr[i] += oRight;
+		}
+	}
+
 	void SetAegState(_EG_state newstate)
 	{
 		StepAEG=AEG_STEP_LUT[newstate];
@@ -1425,23 +1447,32 @@ static SampleType vmuBeepSample()
 constexpr int CDDA_SIZE = 2352 / 2;
 static s16 cdda_sector[CDDA_SIZE];
 static u32 cdda_index = CDDA_SIZE;
+static s16 cdda_prefetched[CDDA_SIZE];
+static bool cdda_prefetch_ready;
 
-void AICA_Sample()
+void AICA_PrefetchCDDA(u32 samples)
 {
-	SampleType mixl,mixr;
-	mixl = 0;
-	mixr = 0;
-	memset(dsp::state.MIXS, 0, sizeof(dsp::state.MIXS));
+	if (!cdda_prefetch_ready && cdda_index + samples * 2 > CDDA_SIZE)
+	{
+		libCore_CDDA_Sector(cdda_prefetched);
+		cdda_prefetch_ready = true;
+	}
+}
 
-	ChannelEx::StepAll(mixl,mixr);
-	
-	//OK , generated all Channels  , now DSP/ect + final mix ;p
+// Final mix of the channel output with CDDA and the DSP effects. dsp::state.MIXS must be set.
+static void MixSample(SampleType mixl, SampleType mixr, bool dspEnabled)
+{
 	//CDDA EXTS input
-	
 	if (cdda_index>=CDDA_SIZE)
 	{
 		cdda_index=0;
-		libCore_CDDA_Sector(cdda_sector);
+		if (cdda_prefetch_ready)
+		{
+			memcpy(cdda_sector, cdda_prefetched, sizeof(cdda_sector));
+			cdda_prefetch_ready = false;
+		}
+		else
+			libCore_CDDA_Sector(cdda_sector);
 	}
 	s32 EXTS0L=cdda_sector[cdda_index];
 	s32 EXTS0R=cdda_sector[cdda_index+1];
@@ -1457,7 +1488,7 @@ void AICA_Sample()
 	DSPData->EXTS[0] = EXTS0L;
 	DSPData->EXTS[1] = EXTS0R;
 
-	if (config::DSPEnabled)
+	if (dspEnabled)
 	{
 		dsp::step();
 
@@ -1507,6 +1538,53 @@ void AICA_Sample()
 	WriteSample(mixr,mixl);
 }
 
+void AICA_Sample()
+{
+	SampleType mixl,mixr;
+	mixl = 0;
+	mixr = 0;
+	memset(dsp::state.MIXS, 0, sizeof(dsp::state.MIXS));
+
+	ChannelEx::StepAll(mixl,mixr);
+	
+	//OK , generated all Channels  , now DSP/ect + final mix ;p
+	MixSample(mixl, mixr, config::DSPEnabled);
+}
+
+void AICA_SampleBlock(u32 samples)
+{
+	constexpr u32 BLOCK_SIZE = 32;
+	const bool dspEnabled = config::DSPEnabled;
+	// The DSP writes to wave memory, which channels may read back.
+	// Channels can only be generated ahead of time when the DSP is idle.
+	const bool dspIdle = !dspEnabled || (dsp::state.stopped && !dsp::state.dirty);
+
+	while (samples > 0)
+	{
+		const u32 count = std::min(samples, BLOCK_SIZE);
+		samples -= count;
+
+		if (!dspIdle)
+		{
+			for (u32 i = 0; i < count; i++)
+				AICA_Sample();
+			continue;
+		}
+		SampleType mixl[BLOCK_SIZE] {};
+		SampleType mixr[BLOCK_SIZE] {};
+		SampleType mixs[BLOCK_SIZE][16] {};
+
+		for (ChannelEx& channel : Chans)
+			channel.StepBlock(mixl, mixr, mixs, count, dspEnabled);
+
+		for (u32 i = 0; i < count; i++)
+		{
+			memcpy(dsp::state.MIXS, mixs[i], sizeof(dsp::state.MIXS));
+			MixSample(mixl[i], mixr[i], dspEnabled);
+		}
+	}
+}
+
 void channel_serialize(Serializer& ser)
 {
 	for (const ChannelEx& channel : Chans)
@@ -1673,6 +1751,7 @@ void channel_deserialize(Deserializer& deser)
 	}
 	deser >> cdda_sector;
 	deser >> cdda_index;
+	cdda_prefetch_ready = false;
 	if (deser.version() < Deserializer::V9_LIBRETRO)
 	{
 		deser.skip(4 * 64); 		// mxlr
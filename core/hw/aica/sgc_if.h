@@ -2,7 +2,11 @@
 #include "types.h"
 
 void AICA_Sample();
-void AICA_Sample32();
+// Generate a block of samples at once. No AICA register can be written in between.
+void AICA_SampleBlock(u32 samples);
+// Read the next CDDA sector ahead of time if the next block of samples needs it.
+// The gdrom can only be accessed from the emulation thread.
+void AICA_PrefetchCDDA(u32 samples);
 
 void WriteChannelReg(u32 channel, u32 reg, int size);
 
@@ -78,6 +78,11 @@ void aicaarm::avoidRaceCondition()
 
 void aicaarm::run(u32 samples)
 {
+	if (!Arm7Enabled)
+	{
+		libAICA_TimeStepBlock(samples);
+		return;
+	}
 	for (u32 i = 0; i < samples; i++)
 	{
 		runInterpreter(ARM_CYCLES_PER_SAMPLE);
@@ -740,6 +740,11 @@ void *getMemOp(bool Load, bool Byte)
 
 void run(u32 samples)
 {
+	if (!Arm7Enabled)
+	{
+		libAICA_TimeStepBlock(samples);
+		return;
+	}
 	for (u32 i = 0; i < samples; i++)
 	{
 		if (Arm7Enabled)
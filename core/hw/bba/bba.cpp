@@ -224,12 +224,37 @@ int pico_send_eth_frame(const u8 *data, u32 len)
 
 void pci_dma_read(PCIDevice *dev, dma_addr_t addr, void *buf, dma_addr_t len)
 {
-	memcpy(buf, &GAPS_ram[addr & GAPSPCI_RAM_MASK], len);
+	addr &= GAPSPCI_RAM_MASK;
+	if (addr + len > GAPSPCI_RAM_SIZE)
+	{
+		// wrap around
+		memcpy(buf, &GAPS_ram[addr], GAPSPCI_RAM_SIZE - addr);
+		memcpy((u8 *)buf + (GAPSPCI_RAM_SIZE - addr), &GAPS_ram[0], len - (GAPSPCI_RAM_SIZE - addr));
+	}
+	else
+		memcpy(buf, &GAPS_ram[addr], len);
 }
 
 void pci_dma_write(PCIDevice *dev, dma_addr_t addr, const void *buf, dma_addr_t len)
 {
-	memcpy(&GAPS_ram[addr & GAPSPCI_RAM_MASK], buf, len);
+	addr &= GAPSPCI_RAM_MASK;
+	if (addr + len > GAPSPCI_RAM_SIZE)
+	{
+		// wrap around
+		memcpy(&GAPS_ram[addr], buf, GAPSPCI_RAM_SIZE - addr);
+		memcpy(&GAPS_ram[0], (const u8 *)buf + (GAPSPCI_RAM_SIZE - addr), len - (GAPSPCI_RAM_SIZE - addr));
+	}
+	else
+		memcpy(&GAPS_ram[addr], buf, len);
+}
+
+void *pci_dma_map(PCIDevice *dev, dma_addr_t addr, dma_addr_t len)
+{
+	addr &= GAPSPCI_RAM_MASK;
+	if (addr + len > GAPSPCI_RAM_SIZE)
+		// not contiguous
+		return nullptr;
+	return &GAPS_ram[addr];
 }
 
 void bba_Serialize(Serializer& ser)
@@ -17,6 +17,7 @@
     along with Flycast.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "flashrom.h"
+#include "hw/mem/mem_watch.h"
 #include "oslib/oslib.h"
 #include "stdclass.h"
 
@@ -35,6 +36,24 @@ bool MemChip::Load(const std::string& file)
 	return false;
 }
 
+WritableChip::WritableChip(u32 size, u32 write_protect_size)
+	: MemChip(size, write_protect_size)
+{
+	watched = memwatch::bufferWatcher.add(data, size);
+}
+
+WritableChip::~WritableChip()
+{
+	if (watched)
+		memwatch::bufferWatcher.remove(data);
+}
+
+void WritableChip::modified(u32 offset, u32 len)
+{
+	if (watched)
+		memwatch::bufferWrite(data + offset, len);
+}
+
 void WritableChip::Save(const std::string& file)
 {
 	FILE *f = nowide::fopen(file.c_str(), "wb");
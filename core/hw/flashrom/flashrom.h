@@ -62,10 +62,17 @@ public:
 struct WritableChip : MemChip
 {
 protected:
-	WritableChip(u32 size, u32 write_protect_size = 0)
-		: MemChip(size, write_protect_size) {}
+	WritableChip(u32 size, u32 write_protect_size = 0);
+
+	// Must be called before modifying the chip content so that rollbacks can restore it
+	void modified(u32 offset, u32 len = 1);
+
+	// The content is saved by memwatch and isn't included in rollback states
+	bool watched;
 
 public:
+	~WritableChip() override;
+
 	virtual void Write(u32 addr, u32 data, u32 size) = 0;
 
 	bool Reload() override
@@ -91,6 +98,7 @@ struct SRamChip : WritableChip
 		addr&=mask;
 		if (addr < write_protect_size)
 			return;
+		modified(addr, sz);
 		switch (sz)
 		{
 		case 1:
@@ -109,11 +117,13 @@ struct SRamChip : WritableChip
 
 	void Serialize(Serializer& ser) const override
 	{
-		ser.serialize(&this->data[write_protect_size], size - write_protect_size);
+		if (!ser.rollback() || !watched)
+			ser.serialize(&this->data[write_protect_size], size - write_protect_size);
 	}
 	void Deserialize(Deserializer& deser) override
 	{
-		deser.deserialize(&this->data[write_protect_size], size - write_protect_size);
+		if (!deser.rollback() || !watched)
+			deser.deserialize(&this->data[write_protect_size], size - write_protect_size);
 	}
 };
 
@@ -288,7 +298,10 @@ struct DCFlashChip : WritableChip
 			break;
 		case FS_ByteProgram:
 			if ((addr & 0x1e000) != 0x1a000 && addr >= write_protect_size)
+			{
+				modified(addr);
 				data[addr] &= val;
+			}
 			state = FS_Normal;
 			break;
 
@@ -327,6 +340,7 @@ struct DCFlashChip : WritableChip
 				// chip erase
 				INFO_LOG(FLASHROM, "Erasing Chip!");
 				u8 save[0x2000];
+				modified(write_protect_size, size - write_protect_size);
 				// this area is write-protected
 				memcpy(save, data + 0x1a000, 0x2000);
 				memset(data + write_protect_size, 0xff, size - write_protect_size);
@@ -368,7 +382,10 @@ struct DCFlashChip : WritableChip
 					}
 					INFO_LOG(FLASHROM, "Erase Sector %08X!", addr);
 					if (start != nullptr)
+					{
+						modified((u32)((u8 *)start - data), len);
 						memset(start, 0xFF, len);
+					}
 				}
 			}
 			else if (val != 0xf0)
@@ -602,6 +619,7 @@ private:
 
 	void write_physical_block(u32 offset, u32 phys_id, const void *data)
 	{
+		modified(offset + phys_id * FLASH_BLOCK_SIZE, FLASH_BLOCK_SIZE);
 		memcpy(&this->data[offset + phys_id * FLASH_BLOCK_SIZE], data, FLASH_BLOCK_SIZE);
 	}
 
@@ -714,13 +732,15 @@ private:
 	void Serialize(Serializer& ser) const override
 	{
 		ser << state;
-		ser.serialize(&this->data[write_protect_size], size - write_protect_size);
+		if (!ser.rollback() || !watched)
+			ser.serialize(&this->data[write_protect_size], size - write_protect_size);
 	}
 
 	void Deserialize(Deserializer& deser) override
 	{
 		deser >> state;
-		deser.deserialize(&this->data[write_protect_size], size - write_protect_size);
+		if (!deser.rollback() || !watched)
+			deser.deserialize(&this->data[write_protect_size], size - write_protect_size);
 	}
 
 	void erase_partition(u32 part_id)
@@ -728,6 +748,7 @@ private:
 		int offset, size;
 		GetPartitionInfo(part_id, &offset, &size);
 
+		modified(offset, size);
 		memset(data + offset, 0xFF, size);
 	}
 
@@ -5,6 +5,7 @@
 #include "oslib/audiostream.h"
 #include "oslib/oslib.h"
 #include "hw/aica/sgc_if.h"
+#include "hw/mem/mem_watch.h"
 #include <zlib.h>
 #include "dojo/DojoSession.hpp"
 #include "dojo/DojoFile.hpp"
@@ -381,6 +382,12 @@ struct maple_sega_vmu: maple_base
 	u8 lcd_data[192];
 	u8 lcd_data_decoded[48*32];
 
+	maple_sega_vmu()
+	{
+		// flash content is saved by memwatch during rollbacks
+		memwatch::bufferWatcher.add(flash_data, sizeof(flash_data));
+	}
+
 	MapleDeviceType get_device_type() override
 	{
 		return MDT_SegaVMU;
@@ -389,14 +396,16 @@ struct maple_sega_vmu: maple_base
 	void serialize(Serializer& ser) const override
 	{
 		maple_base::serialize(ser);
-		ser << flash_data;
+		if (!ser.rollback())
+			ser << flash_data;
 		ser << lcd_data;
 		ser << lcd_data_decoded;
 	}
 	void deserialize(Deserializer& deser) override
 	{
 		maple_base::deserialize(deser);
-		deser >> flash_data;
+		if (!deser.rollback())
+			deser >> flash_data;
 		deser >> lcd_data;
 		deser >> lcd_data_decoded;
 		for (u8 b : lcd_data)
@@ -461,6 +470,7 @@ struct maple_sega_vmu: maple_base
 
 	~maple_sega_vmu() override
 	{
+		memwatch::bufferWatcher.remove(flash_data);
 		if (file != nullptr)
 			std::fclose(file);
 	}
@@ -670,6 +680,7 @@ struct maple_sega_vmu: maple_base
 							skip(write_len);
 							return MDRE_FileError; //invalid params
 						}
+						memwatch::bufferWrite(&flash_data[write_adr], write_len);
 						rptr(&flash_data[write_adr],write_len);
 
 						if (file != nullptr)
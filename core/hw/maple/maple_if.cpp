@@ -7,6 +7,8 @@
 #include "hw/sh4/sh4_sched.h"
 #include "cfg/option.h"
 #include "network/ggpo.h"
+#include "input/gamepad_device.h"
+#include "profiler/latency.h"
 #include <dojo/DojoSession.hpp>
 
 enum MaplePattern
@@ -144,6 +146,11 @@ static void maple_DoDma()
 		while (dojo.isPaused && !dojo.disconnect_toggle);
 	}
 
+	// Poll the host devices right before reading the controllers. This is already done by ggpo::getInput
+	// in single-threaded mode.
+	if (config::JitInputPolling && config::ThreadedRendering)
+		jitPollInput();
+
 	if (dojo.PlayMatch && dojo.maple_inputs.size() > 0)
 	{
 		ggpo::setMapleInput(mapleInputState);
@@ -152,6 +159,7 @@ static void maple_DoDma()
 	}
 	else
 		ggpo::getInput(mapleInputState);
+	latency::mapleDma(mapleInputState[0].kcode);
 
 	const bool swap_msb = (SB_MMSEL == 0);
 	u32 xfer_count = 0;
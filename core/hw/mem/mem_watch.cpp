@@ -17,6 +17,9 @@
     along with Flycast.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "mem_watch.h"
+#include "hw/sh4/sh4_if.h"
+
+#include <algorithm>
 
 namespace memwatch
 {
@@ -25,6 +28,9 @@ VramWatcher vramWatcher;
 RamWatcher ramWatcher;
 AicaRamWatcher aramWatcher;
 ElanRamWatcher elanWatcher;
+BufferWatcher bufferWatcher;
+Watchpoints watchpoints;
+bool runAhead;
 
 void AicaRamWatcher::protectMem(u32 addr, u32 size)
 {
@@ -73,5 +79,117 @@ u32 ElanRamWatcher::getMemOffset(void *p)
 	return (u32)((u8 *)p - RAM);
 }
 
+bool Watchpoints::add(u32 addr, u32 size)
+{
+	// Area 3 (system RAM) in any region
+	if (size == 0 || (addr & 0x1C000000) != 0x0C000000)
+		return false;
+	const u32 offset = addr & RAM_MASK;
+	if (offset + size > RAM_SIZE)
+		return false;
+	for (const Watch& watch : watches)
+		if (watch.addr == addr && watch.size == size)
+			return true;
+	watches.push_back({ addr, offset, size });
+	protect();
+	return true;
+}
+
+bool Watchpoints::remove(u32 addr, u32 size)
+{
+	auto it = std::find_if(watches.begin(), watches.end(), [addr, size](const Watch& watch) {
+		return watch.addr == addr && watch.size == size;
+	});
+	if (it == watches.end())
+		return false;
+	const Watch watch = *it;
+	watches.erase(it);
+	for (u32 page = watch.offset & ~PAGE_MASK; page < watch.offset + watch.size; page += PAGE_SIZE)
+		// Keep the pages protected if they contain code or other watched ranges
+		if (!isWatched(page) && !bm_IsRamPageProtected(page))
+			bm_UnlockPage(page);
+	return true;
+}
+
+void Watchpoints::clear()
+{
+	while (!watches.empty())
+		remove(watches.back().addr, watches.back().size);
+	unprotectedPages.clear();
+}
+
+bool Watchpoints::isWatched(u32 page) const
+{
+	for (const Watch& watch : watches)
+		if (page < watch.offset + watch.size && page + PAGE_SIZE > watch.offset)
+			return true;
+	return false;
+}
+
+void Watchpoints::protect()
+{
+	for (const Watch& watch : watches)
+		bm_LockPage(watch.offset & ~PAGE_MASK, ((watch.offset + watch.size - 1) | PAGE_MASK) + 1 - (watch.offset & ~PAGE_MASK));
 }
 
+bool Watchpoints::writeAccess(void *p)
+{
+	if (watches.empty())
+		return false;
+	const u32 offset = bm_getRamOffset(p);
+	if (offset == (u32)-1)
+		return false;
+	const u32 page = offset & ~PAGE_MASK;
+	if (!isWatched(page))
+		return false;
+	// Let the write complete and invalidate the code in this page, if any
+	bm_UnlockPage(page);
+	bm_RamWriteAccess(offset);
+	unprotectedPages.push_back(page);
+	if (suspended)
+		return true;
+
+	for (const Watch& watch : watches)
+	{
+		// The access size is unknown: assume that aligned accesses overlapping the range start are hits
+		if (offset >= (watch.offset & ~3) && offset < watch.offset + watch.size)
+		{
+			if (hitAddress == 0)
+				hitAddress = watch.addr + std::max(offset, watch.offset) - watch.offset;
+			break;
+		}
+	}
+	if (!pending)
+	{
+		// End the time slice after the current instruction
+		pending = true;
+		savedCycles = Sh4cntx.cycle_counter;
+		Sh4cntx.cycle_counter = 0;
+	}
+	return true;
+}
+
+u32 Watchpoints::acknowledge()
+{
+	if (pending)
+	{
+		Sh4cntx.cycle_counter += savedCycles;
+		pending = false;
+	}
+	for (u32 page : unprotectedPages)
+		bm_LockPage(page);
+	unprotectedPages.clear();
+	u32 addr = hitAddress;
+	hitAddress = 0;
+	return addr;
+}
+
+void Watchpoints::resume()
+{
+	suspended = false;
+	for (u32 page : unprotectedPages)
+		bm_LockPage(page);
+	unprotectedPages.clear();
+}
+
+}
@@ -16,6 +16,7 @@
     You should have received a copy of the GNU General Public License
     along with Flycast.  If not, see <https://www.gnu.org/licenses/>.
 */
+#pragma once
 #include "types.h"
 #include "_vmem.h"
 #include "hw/aica/aica_if.h"
@@ -25,6 +26,7 @@
 #include "hw/pvr/elan.h"
 #include "rend/TexCache.h"
 #include <unordered_map>
+#include <vector>
 
 namespace memwatch
 {
@@ -91,6 +93,33 @@ public:
 		std::swap(pages, other);
 		pages = PageMap();
 	}
+
+	// Protect the modified pages again and forget their content
+	void discard()
+	{
+		protect();
+		pages.clear();
+	}
+
+	// Restore the original content of all modified pages.
+	// Pages are kept unprotected until the next call to discard()
+	void restore()
+	{
+		for (const auto& pair : pages)
+		{
+			void *page = static_cast<T&>(*this).getMemPage(pair.first);
+			if (page == nullptr)
+				continue;
+			// the page may have been protected again, by the texture cache for example
+			static_cast<T&>(*this).unprotectMem(pair.first, PAGE_SIZE);
+			memcpy(page, &pair.second.data[0], PAGE_SIZE);
+			static_cast<T&>(*this).pageRestored(pair.first);
+		}
+	}
+
+protected:
+	void pageRestored(u32 addr) {
+	}
 };
 
 class VramWatcher : public Watcher<VramWatcher>
@@ -113,6 +142,11 @@ protected:
 		return _vmem_get_vram_offset(p);
 	}
 
+	void pageRestored(u32 addr)
+	{
+		VramLockedWriteOffset(addr);
+	}
+
 public:
 	void *getMemPage(u32 addr)
 	{
@@ -179,15 +213,143 @@ public:
 	}
 };
 
+// Watches host buffers that are only modified by emulator code, such as flash chips and VMUs.
+// Their pages can't be protected so writers must call hit() before modifying them.
+class BufferWatcher : public Watcher<BufferWatcher>
+{
+	friend class Watcher<BufferWatcher>;
+
+	struct Buffer
+	{
+		u8 *data;
+		u32 size;
+		u32 offset;
+	};
+	std::vector<Buffer> buffers;
+	u32 nextOffset = 0;
+
+protected:
+	void protectMem(u32 addr, u32 size) {
+	}
+	void unprotectMem(u32 addr, u32 size) {
+	}
+
+	u32 getMemOffset(void *p)
+	{
+		for (const Buffer& buffer : buffers)
+			if ((u8 *)p >= buffer.data && (u8 *)p < buffer.data + buffer.size)
+				return buffer.offset + (u32)((u8 *)p - buffer.data);
+		return -1;
+	}
+
+public:
+	// Returns false if the buffer can't be watched. It must then be saved in rollback states.
+	bool add(u8 *data, u32 size)
+	{
+		if (size == 0 || (size & PAGE_MASK) != 0)
+			return false;
+		buffers.push_back({ data, size, nextOffset });
+		nextOffset += size;
+		return true;
+	}
+
+	void remove(u8 *data)
+	{
+		for (auto it = buffers.begin(); it != buffers.end(); ++it)
+			if (it->data == data)
+			{
+				buffers.erase(it);
+				break;
+			}
+	}
+
+	void write(void *p, u32 size)
+	{
+		u32 offset = getMemOffset(p);
+		if (offset == (u32)-1)
+			return;
+		// pages are relative to the start of the buffer
+		for (u32 page = offset & ~PAGE_MASK; page < offset + size; page += PAGE_SIZE)
+			hit(getMemPage(page));
+	}
+
+	// Returns nullptr if the buffer has been removed
+	void *getMemPage(u32 addr)
+	{
+		for (const Buffer& buffer : buffers)
+			if (addr >= buffer.offset && addr < buffer.offset + buffer.size)
+				return buffer.data + (addr - buffer.offset);
+		return nullptr;
+	}
+};
+
+// Debugger write watchpoints on system RAM.
+// Only the pages containing a watched range are protected so that other accesses run at full speed.
+// When a watched page is written to, the page is unprotected to let the write complete and the current
+// time slice is ended. The SH4 core must then call acknowledge() to protect the page again.
+class Watchpoints
+{
+	struct Watch
+	{
+		u32 addr;	// guest address
+		u32 offset;	// RAM offset
+		u32 size;
+	};
+	std::vector<Watch> watches;
+	std::vector<u32> unprotectedPages;
+	bool pending = false;
+	bool suspended = false;
+	u32 hitAddress = 0;
+	int savedCycles = 0;
+
+	bool isWatched(u32 page) const;
+
+public:
+	// Returns false if the range isn't in system RAM
+	bool add(u32 addr, u32 size);
+	bool remove(u32 addr, u32 size);
+	void clear();
+	bool empty() const {
+		return watches.empty();
+	}
+	void protect();
+
+	bool writeAccess(void *p);
+	// True if a watched page has been written to during the current time slice
+	bool isPending() const {
+		return pending;
+	}
+	// Protect the written pages again and restore the time slice.
+	// Returns the guest address of the watched range that was written to, or 0 if none.
+	u32 acknowledge();
+
+	// Writes done by the debugger while suspended don't trigger watchpoints
+	void suspend() {
+		suspended = true;
+	}
+	void resume();
+};
+
 extern VramWatcher vramWatcher;
 extern RamWatcher ramWatcher;
 extern AicaRamWatcher aramWatcher;
 extern ElanRamWatcher elanWatcher;
+extern BufferWatcher bufferWatcher;
+extern Watchpoints watchpoints;
+// Set by the emulator when run-ahead is active
+extern bool runAhead;
+
+// Memory writes are watched for netplay rollbacks and run-ahead
+inline static bool enabled()
+{
+	return config::GGPOEnable || runAhead;
+}
 
 inline static bool writeAccess(void *p)
 {
-	if (!config::GGPOEnable)
-		return false;
+	const bool watchpoint = watchpoints.writeAccess(p);
+	if (!enabled())
+		return watchpoint;
 	if (ramWatcher.hit(p))
 	{
 		bm_RamWriteAccess(p);
@@ -200,17 +362,18 @@ inline static bool writeAccess(void *p)
 	}
 	if (settings.platform.isNaomi2() && elanWatcher.hit(p))
 		return true;
-	return aramWatcher.hit(p);
+	return aramWatcher.hit(p) || watchpoint;
 }
 
 inline static void protect()
 {
-	if (!config::GGPOEnable)
+	if (!enabled())
 		return;
 	vramWatcher.protect();
 	ramWatcher.protect();
 	aramWatcher.protect();
 	elanWatcher.protect();
+	bufferWatcher.protect();
 }
 
 inline static void unprotect()
@@ -219,6 +382,7 @@ inline static void unprotect()
 	ramWatcher.unprotect();
 	aramWatcher.unprotect();
 	elanWatcher.unprotect();
+	bufferWatcher.unprotect();
 }
 
 inline static void reset()
@@ -227,6 +391,32 @@ inline static void reset()
 	ramWatcher.reset();
 	aramWatcher.reset();
 	elanWatcher.reset();
+	bufferWatcher.reset();
+}
+
+inline static void discard()
+{
+	vramWatcher.discard();
+	ramWatcher.discard();
+	aramWatcher.discard();
+	elanWatcher.discard();
+	bufferWatcher.discard();
+}
+
+inline static void restore()
+{
+	vramWatcher.restore();
+	ramWatcher.restore();
+	aramWatcher.restore();
+	elanWatcher.restore();
+	bufferWatcher.restore();
+}
+
+// Must be called before modifying a buffer registered with bufferWatcher
+inline static void bufferWrite(void *p, u32 size = 1)
+{
+	if (enabled())
+		bufferWatcher.write(p, size);
 }
 
 }
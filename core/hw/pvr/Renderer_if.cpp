@@ -9,6 +9,7 @@
 #include "hw/holly/holly_intc.h"
 #include "hw/sh4/sh4_if.h"
 #include "profiler/fc_profiler.h"
+#include "profiler/latency.h"
 #include "network/ggpo.h"
 
 #include <mutex>
@@ -235,6 +236,7 @@ private:
 		if (renderer->Present())
 		{
 			presented = true;
+			latency::present();
 			if (!config::ThreadedRendering && !ggpo::active() && !config::GGPOEnable)
 				sh4_cpu.Stop();
 #ifdef LIBRETRO
@@ -399,7 +401,11 @@ void rend_start_render()
 	ctx->rend.fog_clamp_max = FOG_CLAMP_MAX;
 
 	if (!ctx->rend.isRTT)
+	{
 		ggpo::endOfFrame();
+		emu.endOfFrame();
+		latency::startRender();
+	}
 
 	if (QueueRender(ctx))
 	{
@@ -445,6 +451,8 @@ void rend_vblank()
 			if (!config::EmulateFramebuffer)
 				DEBUG_LOG(PVR, "Direct framebuffer write detected");
 		}
+		else
+			emu.endOfFrame();
 		fb_dirty = false;
 	}
 	render_called = false;
@@ -2,6 +2,7 @@
 #include "ta_ctx.h"
 #include "hw/holly/holly_intc.h"
 #include "pvr_mem.h"
+#include "profiler/latency.h"
 
 /*
 	Threaded TA Implementation
@@ -515,6 +516,8 @@ void ta_vtx_ListInit(bool continuation)
 
 	ta_cur_state = TAS_NS;
 	ta_fsm_cl = 7;
+	if (!continuation)
+		latency::taListInit();
 	if (settings.platform.isNaomi2())
 		ta_parse_reset();
 }
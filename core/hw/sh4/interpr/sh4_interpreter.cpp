@@ -3,6 +3,8 @@
 */
 
 #include "types.h"
+// must be included before the sh4 register macros are defined
+#include "hw/mem/mem_watch.h"
 
 #include "../sh4_interpreter.h"
 #include "../sh4_opcode_list.h"
@@ -75,6 +77,9 @@ static void Sh4_int_Step()
 	try {
 		u32 op = ReadNexOp();
 		ExecuteOpcode(op);
+		if (memwatch::watchpoints.isPending())
+			// Stepping stops after this instruction anyway
+			memwatch::watchpoints.acknowledge();
 	} catch (const SH4ThrownException& ex) {
 		Do_Exception(ex.epc, ex.expEvn, ex.callVect);
 		p_sh4rcb->cntx.cycle_counter -= CPU_RATIO * 5;	// an exception requires the instruction pipeline to drain, so approx 5 cycles
@@ -147,6 +152,8 @@ void ExecuteDelayslot_RTE()
 // every SH4_TIMESLICE cycles
 int UpdateSystem()
 {
+	if (memwatch::watchpoints.isPending())
+		debugger::watchpointHit(memwatch::watchpoints.acknowledge());
 	Sh4cntx.sh4_sched_next -= SH4_TIMESLICE;
 	if (Sh4cntx.sh4_sched_next < 0)
 		sh4_sched_tick(SH4_TIMESLICE);
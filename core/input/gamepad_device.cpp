@@ -24,6 +24,7 @@
 #include "emulator.h"
 #include "hw/maple/maple_devs.h"
 #include "hw/naomi/card_reader.h"
+#include "profiler/latency.h"
 
 #include <algorithm>
 #include <mutex>
@@ -47,8 +48,15 @@ u8 lt[4];
 u8 kb_shift[MAPLE_PORTS];	// shift keys pressed (bitmask)
 u8 kb_key[MAPLE_PORTS][6];	// normal keys pressed
 
+u64 lastInputChangeTime[4];
+u64 lastInputPollTime;
+static void (*jitInputPoller)();
+static thread_local bool jitPolling;
+
 std::vector<std::shared_ptr<GamepadDevice>> GamepadDevice::_gamepads;
 std::mutex GamepadDevice::_gamepads_mutex;
+std::vector<GamepadDevice::DeferredInput> GamepadDevice::deferredInputs;
+std::mutex GamepadDevice::deferredInputsMutex;
 bool loading_state;
 bool loadSaveStateDisabled;
 
@@ -232,6 +240,7 @@ bool GamepadDevice::handleButtonInput(int port, DreamcastKey key, bool pressed)
 				kcode_next[port] = ~0u;
 			}
 
+			const u32 prevKcode = kcode[port];
 			if (pressed)
 				kcode[port] &= ~key;
 			else
@@ -243,6 +252,8 @@ bool GamepadDevice::handleButtonInput(int port, DreamcastKey key, bool pressed)
 			}
 			CorrectCardinals(port);
 			kcode_prev[port] = kcode[port];
+			if (kcode[port] != prevKcode)
+				lastInputChangeTime[port] = (u64)(os_GetSeconds() * 1000000.0);
 		}
 #ifdef TEST_AUTOMATION
 		if (record_input != NULL)
@@ -251,6 +262,13 @@ bool GamepadDevice::handleButtonInput(int port, DreamcastKey key, bool pressed)
 	}
 	else
 	{
+		if (jitPolling)
+		{
+			// Emulator hotkeys must be handled by the UI thread
+			std::lock_guard<std::mutex> lock(deferredInputsMutex);
+			deferredInputs.push_back({ _unique_id, port, key, pressed });
+			return true;
+		}
 		switch (key)
 		{
 		case EMU_BTN_ESCAPE:
@@ -940,3 +958,36 @@ void replay_input()
 	}
 }
 #endif
+
+void setJitInputPoller(void (*poller)())
+{
+	jitInputPoller = poller;
+}
+
+void jitPollInput()
+{
+	if (jitInputPoller == nullptr)
+		return;
+	jitPolling = true;
+	jitInputPoller();
+	jitPolling = false;
+	latency::poll();
+	lastInputPollTime = (u64)(os_GetSeconds() * 1000000.0);
+}
+
+void GamepadDevice::handleDeferredInputs()
+{
+	std::vector<DeferredInput> inputs;
+	{
+		std::lock_guard<std::mutex> lock(deferredInputsMutex);
+		if (deferredInputs.empty())
+			return;
+		std::swap(inputs, deferredInputs);
+	}
+	for (const DeferredInput& input : inputs)
+	{
+		std::shared_ptr<GamepadDevice> gamepad = GetGamepad(input.uniqueId);
+		if (gamepad != nullptr)
+			gamepad->handleButtonInput(input.port, input.key, input.pressed);
+	}
+}
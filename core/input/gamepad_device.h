@@ -80,6 +80,9 @@ public:
 	static std::shared_ptr<GamepadDevice> GetGamepad(std::string uid);
 	static void SaveMaplePorts();
 
+	// Handle the emulator hotkeys received while polling input on the emulation thread
+	static void handleDeferredInputs();
+
 	static void load_system_mappings();
 	bool find_mapping(int system = settings.platform.system);
 	virtual void resetMappingToDefault(bool arcade, bool gamepad) {
@@ -172,6 +175,16 @@ private:
 
 	static std::vector<std::shared_ptr<GamepadDevice>> _gamepads;
 	static std::mutex _gamepads_mutex;
+
+	struct DeferredInput
+	{
+		std::string uniqueId;
+		int port;
+		DreamcastKey key;
+		bool pressed;
+	};
+	static std::vector<DeferredInput> deferredInputs;
+	static std::mutex deferredInputsMutex;
 };
 
 #ifdef TEST_AUTOMATION
@@ -182,3 +195,14 @@ extern u32 kcode[4];
 extern u8 rt[4], lt[4];
 extern s8 joyx[4], joyy[4];
 extern s8 joyrx[4], joyry[4];
+
+// Host time in microseconds of the last controller button change of each port
+extern u64 lastInputChangeTime[4];
+// Host time in microseconds of the last just-in-time input poll
+extern u64 lastInputPollTime;
+
+// Platforms can register a function that polls the host input devices that are safe
+// to read from the emulation thread. When just-in-time input polling is enabled, it is called
+// by the maple bus right before reading the controllers.
+void setJitInputPoller(void (*poller)());
+void jitPollInput();
@@ -5,6 +5,7 @@
 #include <fcntl.h>
 #include <linux/input.h>
 #include <unistd.h>
+#include <mutex>
 
 #ifdef USE_UDEV
 #include <libudev.h>
@@ -13,6 +14,8 @@
 #define EVDEV_DEVICE_STRING "/dev/input/event%d"
 
 static int maple_port = 0;
+// Devices can be polled by the emulation thread when just-in-time input polling is enabled
+static std::mutex evdevMutex;
 
 static void input_evdev_add_device(const char *devnode)
 {
@@ -196,6 +199,7 @@ void input_evdev_init()
 
 void input_evdev_close()
 {
+	std::lock_guard<std::mutex> lock(evdevMutex);
 #ifdef USE_UDEV
 	udev_term();
 #endif
@@ -204,6 +208,7 @@ void input_evdev_close()
 
 bool input_evdev_handle()
 {
+	std::lock_guard<std::mutex> lock(evdevMutex);
 #ifdef USE_UDEV
 	get_udev_events();
 #endif
@@ -211,4 +216,10 @@ bool input_evdev_handle()
 	return true;
 }
 
+void input_evdev_poll()
+{
+	std::lock_guard<std::mutex> lock(evdevMutex);
+	EvdevGamepadDevice::PollDevices();
+}
+
 #endif	// USE_EVDEV
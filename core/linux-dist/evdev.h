@@ -3,3 +3,5 @@
 extern void input_evdev_init();
 extern void input_evdev_close();
 extern bool input_evdev_handle();
+// Only reads the opened devices. Can be called from any thread.
+extern void input_evdev_poll();
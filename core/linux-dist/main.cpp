@@ -10,6 +10,7 @@
 #include "oslib/directory.h"
 #include "oslib/oslib.h"
 #include "stdclass.h"
+#include "input/gamepad_device.h"
 
 #include <csignal>
 #include <string>
@@ -57,6 +58,16 @@ void os_SetupInput()
 #if defined(USE_SDL)
 	input_sdl_init();
 #endif
+#if defined(USE_EVDEV) || defined(USE_SDL)
+	setJitInputPoller([]() {
+#if defined(USE_EVDEV)
+		input_evdev_poll();
+#endif
+#if defined(USE_SDL)
+		input_sdl_poll_joysticks();
+#endif
+	});
+#endif
 }
 
 void os_TermInput()
@@ -5,6 +5,8 @@
 #include "LogManager.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstring>
 #include <locale>
@@ -12,6 +14,8 @@
 #include <ostream>
 #include <string>
 #include <fstream>
+#include <thread>
+#include <zlib.h>
 
 #include "ConsoleListener.h"
 #include "InMemoryListener.h"
@@ -48,7 +52,13 @@ public:
 			return;
 
 		std::lock_guard<std::mutex> lk(m_log_lock);
-		m_logfile << msg << std::flush;
+		m_logfile << msg;
+	}
+
+	void Flush() override
+	{
+		std::lock_guard<std::mutex> lk(m_log_lock);
+		m_logfile.flush();
 	}
 
 	bool IsValid() const { return m_logfile.good(); }
@@ -61,6 +71,204 @@ private:
 	bool m_enable;
 };
 
+// Appends a gzip stream to the log file
+class CompressedFileLogListener : public LogListener
+{
+public:
+	CompressedFileLogListener(const std::string& filename)
+	{
+		m_logfile = nowide::fopen(filename.c_str(), "ab");
+		if (m_logfile != nullptr
+				&& deflateInit2(&m_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			fclose(m_logfile);
+			m_logfile = nullptr;
+		}
+	}
+
+	~CompressedFileLogListener() override
+	{
+		if (m_logfile == nullptr)
+			return;
+		Deflate(nullptr, 0, Z_FINISH);
+		deflateEnd(&m_stream);
+		fclose(m_logfile);
+	}
+
+	void Log(LogTypes::LOG_LEVELS, const char* msg) override
+	{
+		if (!IsValid())
+			return;
+		std::lock_guard<std::mutex> lk(m_log_lock);
+		Deflate(msg, strlen(msg), Z_NO_FLUSH);
+	}
+
+	void Flush() override
+	{
+		if (!IsValid())
+			return;
+		std::lock_guard<std::mutex> lk(m_log_lock);
+		// Make everything logged so far readable
+		Deflate(nullptr, 0, Z_SYNC_FLUSH);
+		fflush(m_logfile);
+	}
+
+	bool IsValid() const { return m_logfile != nullptr; }
+
+private:
+	void Deflate(const char *data, size_t size, int flush)
+	{
+		u8 out[16384];
+		m_stream.next_in = (Bytef *)data;
+		m_stream.avail_in = (uInt)size;
+		do {
+			m_stream.next_out = out;
+			m_stream.avail_out = sizeof(out);
+			deflate(&m_stream, flush);
+			fwrite(out, 1, sizeof(out) - m_stream.avail_out, m_logfile);
+		} while (m_stream.avail_out == 0);
+	}
+
+	std::mutex m_log_lock;
+	FILE *m_logfile = nullptr;
+	z_stream m_stream{};
+};
+
+// Messages are formatted by the calling thread into a lock-free ring buffer,
+// and written to the listeners by a background thread.
+class LogManager::AsyncQueue
+{
+public:
+	AsyncQueue(LogManager& manager) : m_manager(manager)
+	{
+		for (u32 i = 0; i < Size; i++)
+			m_ring[i].sequence.store(i, std::memory_order_relaxed);
+		m_thread = std::thread(&AsyncQueue::Run, this);
+	}
+
+	~AsyncQueue()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_thread_mutex);
+			m_stopping = true;
+		}
+		m_wake_up.notify_one();
+		m_thread.join();
+		Drain();
+	}
+
+	void Push(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
+			const char* format, va_list args)
+	{
+		// Reserve a record
+		u32 pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		Record *record;
+		for (;;)
+		{
+			record = &m_ring[pos % Size];
+			const int diff = (int)(record->sequence.load(std::memory_order_acquire) - pos);
+			if (diff == 0)
+			{
+				if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else
+			{
+				if (diff < 0)
+				{
+					// Full: wait for the writer thread
+					m_wake_up.notify_one();
+					std::this_thread::yield();
+				}
+				pos = m_enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+		record->level = level;
+		record->type = type;
+		record->file = file;
+		record->line = line;
+		record->time = os_GetSeconds();
+		CharArrayFromFormatV(record->text, MAX_MSGLEN, format, args);
+		record->sequence.store(pos + 1, std::memory_order_release);
+
+		if (pos - m_dequeue_pos.load(std::memory_order_relaxed) == Size / 2)
+			m_wake_up.notify_one();
+	}
+
+	// Write a message immediately, after all the pending ones
+	void WriteNow(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
+			const char* format, va_list args)
+	{
+		char text[MAX_MSGLEN];
+		const double time = os_GetSeconds();
+		CharArrayFromFormatV(text, MAX_MSGLEN, format, args);
+		std::lock_guard<std::mutex> lock(m_writer_mutex);
+		DrainLocked();
+		m_manager.Write(level, type, file, line, time, text);
+		m_manager.FlushListeners();
+	}
+
+private:
+	struct Record
+	{
+		std::atomic<u32> sequence;
+		LogTypes::LOG_LEVELS level;
+		LogTypes::LOG_TYPE type;
+		const char* file;
+		int line;
+		double time;
+		char text[MAX_MSGLEN];
+	};
+
+	void Run()
+	{
+		std::unique_lock<std::mutex> lock(m_thread_mutex);
+		while (!m_stopping)
+		{
+			m_wake_up.wait_for(lock, std::chrono::milliseconds(10));
+			lock.unlock();
+			Drain();
+			lock.lock();
+		}
+	}
+
+	void Drain()
+	{
+		std::lock_guard<std::mutex> lock(m_writer_mutex);
+		DrainLocked();
+	}
+
+	void DrainLocked()
+	{
+		bool written = false;
+		for (;;)
+		{
+			const u32 pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			Record& record = m_ring[pos % Size];
+			if (record.sequence.load(std::memory_order_acquire) != pos + 1)
+				break;
+			m_manager.Write(record.level, record.type, record.file, record.line, record.time, record.text);
+			record.sequence.store(pos + Size, std::memory_order_release);
+			m_dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+			written = true;
+		}
+		if (written)
+			m_manager.FlushListeners();
+	}
+
+	static constexpr u32 Size = 512;	// must be a power of 2
+	LogManager& m_manager;
+	Record m_ring[Size];
+	std::atomic<u32> m_enqueue_pos{};
+	std::atomic<u32> m_dequeue_pos{};
+	// held by the thread writing to the listeners
+	std::mutex m_writer_mutex;
+	std::thread m_thread;
+	std::mutex m_thread_mutex;
+	std::condition_variable m_wake_up;
+	bool m_stopping = false;
+};
+
 void GenericLog(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
 		const char* fmt, ...)
 {
@@ -137,15 +345,34 @@ LogManager::LogManager()
 #else
 		std::string logPath = "flycast.log";
 #endif
-		FileLogListener *listener = new FileLogListener(logPath);
-		if (!listener->IsValid())
+		LogListener *listener;
+		if (cfgLoadBool("log", "LogCompressed", false))
+		{
+			CompressedFileLogListener *gzListener = new CompressedFileLogListener(logPath + ".gz");
+			if (!gzListener->IsValid())
+			{
+				const char *home = nowide::getenv("HOME");
+				if (home != nullptr)
+				{
+					delete gzListener;
+					gzListener = new CompressedFileLogListener(home + ("/" + logPath + ".gz"));
+				}
+			}
+			listener = gzListener;
+		}
+		else
 		{
-			const char *home = nowide::getenv("HOME");
-			if (home != nullptr)
+			FileLogListener *fileListener = new FileLogListener(logPath);
+			if (!fileListener->IsValid())
 			{
-				delete listener;
-				listener = new FileLogListener(home + ("/" + logPath));
+				const char *home = nowide::getenv("HOME");
+				if (home != nullptr)
+				{
+					delete fileListener;
+					fileListener = new FileLogListener(home + ("/" + logPath));
+				}
 			}
+			listener = fileListener;
 		}
 		RegisterListener(LogListener::FILE_LISTENER, listener);
 		EnableListener(LogListener::FILE_LISTENER, true);
@@ -161,21 +388,25 @@ LogManager::LogManager()
 	}
 
 	m_path_cutoff_point = DeterminePathCutOffPoint();
+
+	if (cfgLoadBool("log", "LogAsync", true))
+		m_async = new AsyncQueue(*this);
 }
 
 LogManager::~LogManager()
 {
+	// Write the pending messages
+	delete m_async;
 	// The log window listener pointer is owned by the GUI code.
 	delete m_listeners[LogListener::CONSOLE_LISTENER];
 	delete m_listeners[LogListener::FILE_LISTENER];
 	delete m_listeners[LogListener::IN_MEMORY_LISTENER];
 }
 
-// Return the current time formatted as Minutes:Seconds:Milliseconds
+// Return the given time formatted as Minutes:Seconds:Milliseconds
 // in the form 00:00:000.
-static std::string GetTimeFormatted()
+static std::string GetTimeFormatted(double now)
 {
-	double now = os_GetSeconds();
 	u32 minutes = (u32)now / 60;
 	u32 seconds = (u32)now % 60;
 	u32 ms = (now - (u32)now) * 1000;
@@ -194,18 +425,41 @@ void LogManager::LogWithFullPath(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE
 	if (!IsEnabled(type, level) || !static_cast<bool>(m_listener_ids))
 		return;
 
+	if (m_async != nullptr)
+	{
+		// Errors and notices are written immediately so that they aren't lost if the program terminates
+		if (level > LogTypes::LERROR)
+			m_async->Push(level, type, file, line, format, args);
+		else
+			m_async->WriteNow(level, type, file, line, format, args);
+		return;
+	}
 	char temp[MAX_MSGLEN];
+	const double time = os_GetSeconds();
 	CharArrayFromFormatV(temp, MAX_MSGLEN, format, args);
+	Write(level, type, file, line, time, temp);
+	FlushListeners();
+}
 
+void LogManager::Write(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file,
+		int line, double time, const char* text)
+{
 	std::string msg =
-			StringFromFormat("%s %s:%u %c[%s]: %s\n", GetTimeFormatted().c_str(), file,
-					line, LogTypes::LOG_LEVEL_TO_CHAR[(int)level], GetShortName(type), temp);
+			StringFromFormat("%s %s:%u %c[%s]: %s\n", GetTimeFormatted(time).c_str(), file,
+					line, LogTypes::LOG_LEVEL_TO_CHAR[(int)level], GetShortName(type), text);
 
 	for (auto listener_id : m_listener_ids)
 		if (m_listeners[listener_id])
 			m_listeners[listener_id]->Log(level, msg.c_str());
 }
 
+void LogManager::FlushListeners()
+{
+	for (auto listener_id : m_listener_ids)
+		if (m_listeners[listener_id])
+			m_listeners[listener_id]->Flush();
+}
+
 LogTypes::LOG_LEVELS LogManager::GetLogLevel() const
 {
 	return m_level;
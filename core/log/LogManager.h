@@ -16,6 +16,8 @@ class LogListener
 public:
   virtual ~LogListener() = default;
   virtual void Log(LogTypes::LOG_LEVELS, const char* msg) = 0;
+  // Called after a batch of messages has been logged
+  virtual void Flush() {}
 
   enum LISTENER
   {
@@ -65,9 +67,15 @@ private:
 	  bool m_enable = false;
   };
 
+  class AsyncQueue;
+
   LogManager();
   ~LogManager();
 
+  void Write(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
+             double time, const char* text);
+  void FlushListeners();
+
   LogManager(const LogManager&) = delete;
   LogManager& operator=(const LogManager&) = delete;
   LogManager(LogManager&&) = delete;
@@ -78,4 +86,5 @@ private:
   std::array<LogListener*, LogListener::NUMBER_OF_LISTENERS> m_listeners{};
   BitSet32 m_listener_ids;
   size_t m_path_cutoff_point = 0;
+  AsyncQueue* m_async = nullptr;
 };
@@ -27,6 +27,13 @@ end
 
 function cbVBlank()
 --  print("vblank x,y=", flycast.input.getAbsCoordinates(1))
+--  local mem = flycast.memory
+--  local view = mem.view(0x8c000000, 0x100)
+--  print("word at 0x8c000010:", view:read32(0x10))
+--  local player = mem.struct({ x = { 0, "f32" }, y = { 4, "f32" }, life = { 8, "s16" } })
+--  local p1 = player:read(0x8c100000)
+--  print("P1 life", p1.life, "P2 life", player:read(0x8c100000 + player.size).life)
+--  print(table.unpack(mem.readMany({ 0x8c000000, 0x8c000100 }, "u16")))
 end
 
 function cbOverlay()
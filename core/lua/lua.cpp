@@ -23,6 +23,7 @@
 #include <LuaBridge/LuaBridge.h>
 #include "rend/gui.h"
 #include "hw/mem/_vmem.h"
+#include "hw/sh4/sh4_mem.h"
 #include "cfg/option.h"
 #include "emulator.h"
 #include "input/gamepad_device.h"
@@ -33,6 +34,10 @@
 #include "imgui/imgui.h"
 #include "dojo/DojoSession.hpp"
 
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
 namespace lua
 {
 const char *CallbackTable = "flycast_callbacks";
@@ -64,10 +69,21 @@ void restorePressedButtons()
 	}
 }
 
+static void asyncVBlank();
+static void stopAsyncVBlank();
+
 static void emuEventCallback(Event event, void *)
 {
 	if (L == nullptr)
 		return;
+	if (event == Event::VBlank && config::LuaAsyncVBlank)
+	{
+		asyncVBlank();
+		return;
+	}
+	if (event == Event::Start || event == Event::Terminate)
+		// Watched regions are specific to the game
+		stopAsyncVBlank();
 	lock_guard lock(mutex);
 	try {
 		LuaRef v = LuaRef::getGlobal(L, CallbackTable);
@@ -121,6 +137,261 @@ void overlay()
 	eventCallback("overlay");
 }
 
+// Asynchronous vblank callback.
+// The script runs on a worker thread and reads a snapshot of the watched memory regions
+// taken at vblank. Calls that modify the emulator state are queued and executed on the
+// emulation thread at the next vblank, in the order they were made:
+// memory writes, input, maple devices, record slots, config setters and the emulator
+// functions (startGame, stopGame, pause, resume, saveState, loadState, exit).
+// Memory reads outside of the watched regions raise an error.
+// Watched regions are forgotten when the game is unloaded.
+
+static thread_local bool inWorker;
+
+class VBlankWorker
+{
+public:
+	// Called on the emulation thread
+	void vblank()
+	{
+		runQueuedActions();
+		std::unique_lock<std::mutex> lock(workMutex);
+		if (pending)
+		{
+			// Still busy with a previous frame
+			DEBUG_LOG(COMMON, "Lua vblank callback skipped");
+			return;
+		}
+		if (!thread.joinable())
+		{
+			stopping = false;
+			thread = std::thread(&VBlankWorker::run, this);
+		}
+		for (Region& region : regions)
+			memcpy(region.data.data(), GetMemPtr(region.address, region.data.size()), region.data.size());
+		pending = true;
+		workAvailable.notify_one();
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(workMutex);
+			stopping = true;
+			workAvailable.notify_one();
+		}
+		if (thread.joinable())
+			thread.join();
+		regions.clear();
+		actions.clear();
+	}
+
+	void watch(u32 address, u32 size)
+	{
+		std::lock_guard<std::mutex> lock(workMutex);
+		// Scripts may watch the same region at each vblank
+		if (getSnapshot(address, size) != nullptr)
+			return;
+		regions.push_back({ address & 0x1fffffff, std::vector<u8>(size) });
+	}
+
+	// Returns the snapshot of the given range if it has been watched
+	const u8 *getSnapshot(u32 address, u32 size) const
+	{
+		address &= 0x1fffffff;
+		for (const Region& region : regions)
+			if (address >= region.address && size <= region.data.size()
+					&& address - region.address <= region.data.size() - size)
+				return &region.data[address - region.address];
+		return nullptr;
+	}
+
+	void queue(std::function<void()>&& action)
+	{
+		std::lock_guard<std::mutex> lock(actionMutex);
+		actions.push_back(std::move(action));
+	}
+
+private:
+	void run()
+	{
+		inWorker = true;
+		std::unique_lock<std::mutex> lock(workMutex);
+		while (true)
+		{
+			workAvailable.wait(lock, [this]() { return pending || stopping; });
+			if (stopping)
+				break;
+			lock.unlock();
+			eventCallback("vblank");
+			lock.lock();
+			pending = false;
+		}
+		pending = false;
+	}
+
+	void runQueuedActions()
+	{
+		std::vector<std::function<void()>> toRun;
+		{
+			std::lock_guard<std::mutex> lock(actionMutex);
+			std::swap(toRun, actions);
+		}
+		for (auto& action : toRun)
+			action();
+	}
+
+	struct Region
+	{
+		u32 address;
+		std::vector<u8> data;
+	};
+	std::vector<Region> regions;
+	std::thread thread;
+	std::mutex workMutex;
+	std::condition_variable workAvailable;
+	bool pending = false;
+	bool stopping = false;
+	std::vector<std::function<void()>> actions;
+	std::mutex actionMutex;
+};
+static VBlankWorker vblankWorker;
+
+static void asyncVBlank()
+{
+	vblankWorker.vblank();
+}
+
+static void stopAsyncVBlank()
+{
+	vblankWorker.stop();
+}
+
+// Run the given action now, or at the next vblank if called from the worker thread
+static void runOnEmuThread(std::function<void()>&& action)
+{
+	if (inWorker)
+		vblankWorker.queue(std::move(action));
+	else
+		action();
+}
+
+// Bulk memory access
+
+enum class MemType { U8, S8, U16, S16, U32, S32, F32, U64 };
+
+static MemType parseMemType(const std::string& name, int arg, lua_State *L)
+{
+	static const std::pair<const char *, MemType> types[] {
+		{ "u8", MemType::U8 }, { "s8", MemType::S8 }, { "u16", MemType::U16 }, { "s16", MemType::S16 },
+		{ "u32", MemType::U32 }, { "s32", MemType::S32 }, { "f32", MemType::F32 }, { "u64", MemType::U64 },
+	};
+	for (const auto& type : types)
+		if (name == type.first)
+			return type.second;
+	luaL_argerror(L, arg, "type must be u8, s8, u16, s16, u32, s32, f32 or u64");
+	return MemType::U8;
+}
+
+static u32 memTypeSize(MemType type)
+{
+	switch (type)
+	{
+	case MemType::U8:
+	case MemType::S8:
+		return 1;
+	case MemType::U16:
+	case MemType::S16:
+		return 2;
+	case MemType::U64:
+		return 8;
+	default:
+		return 4;
+	}
+}
+
+// Returns a pointer to system RAM if the whole range is in it.
+// On the vblank worker thread, returns a pointer to the memory snapshot instead.
+static const u8 *getRamPtr(u32 address, u32 size)
+{
+	if (inWorker)
+		return vblankWorker.getSnapshot(address, size);
+	const u8 *p = GetMemPtr(address, size);
+	if (p == nullptr || size > RAM_SIZE - (address & RAM_MASK))
+		return nullptr;
+	return p;
+}
+
+template<typename T>
+static T readMem(u32 address, const u8 *p)
+{
+	if (p == nullptr)
+	{
+		// Guest memory can only be accessed from the emulation thread
+		if (inWorker)
+			luaL_error(L, "address %08x is not watched", address);
+		return _vmem_readt<T, T>(address);
+	}
+	T v;
+	memcpy(&v, p, sizeof(T));
+	return v;
+}
+
+// Reads a value from the host pointer p if not null, otherwise from the given address
+template<typename K>
+static void setMemValue(LuaRef& t, const K& key, MemType type, u32 address, const u8 *p)
+{
+	switch (type)
+	{
+	case MemType::U8:
+		t[key] = readMem<u8>(address, p);
+		break;
+	case MemType::S8:
+		t[key] = (int)(s8)readMem<u8>(address, p);
+		break;
+	case MemType::U16:
+		t[key] = readMem<u16>(address, p);
+		break;
+	case MemType::S16:
+		t[key] = (int)(s16)readMem<u16>(address, p);
+		break;
+	case MemType::U32:
+		t[key] = readMem<u32>(address, p);
+		break;
+	case MemType::S32:
+		t[key] = (int)(s32)readMem<u32>(address, p);
+		break;
+	case MemType::F32:
+		{
+			u32 v = readMem<u32>(address, p);
+			f32 f;
+			memcpy(&f, &v, sizeof(f));
+			t[key] = f;
+		}
+		break;
+	case MemType::U64:
+		t[key] = readMem<u64>(address, p);
+		break;
+	}
+}
+
+// Reads the values at the given addresses. Returns an array.
+static LuaRef readMany(LuaRef addresses, const std::string& typeName, lua_State *L)
+{
+	luaL_argcheck(L, addresses.isTable(), 1, "table expected");
+	const MemType type = parseMemType(typeName, 2, L);
+	const u32 size = memTypeSize(type);
+	LuaRef t(L);
+	t = newTable(L);
+	const int count = addresses.length();
+	for (int i = 1; i <= count; i++)
+	{
+		u32 address = addresses[i].cast<u32>();
+		setMemValue(t, i, type, address, getRamPtr(address, size));
+	}
+	return t;
+}
+
 template<typename T>
 static LuaRef readMemoryTable(u32 address, int count, lua_State* L)
 {
@@ -128,7 +399,7 @@ static LuaRef readMemoryTable(u32 address, int count, lua_State* L)
 	t = newTable(L);
 	while (count > 0)
 	{
-		t[address] = _vmem_readt<T, T>(address);
+		t[address] = readMem<T>(address, getRamPtr(address, sizeof(T)));
 		address += sizeof(T);
 		count--;
 	}
@@ -136,6 +407,111 @@ static LuaRef readMemoryTable(u32 address, int count, lua_State* L)
 	return t;
 }
 
+template<typename T>
+static T readMemory(u32 address)
+{
+	return readMem<T>(address, getRamPtr(address, sizeof(T)));
+}
+
+template<typename T>
+static void writeMemory(u32 address, T data)
+{
+	runOnEmuThread([address, data]() {
+		_vmem_writet<T>(address, data);
+	});
+}
+
+// Memory regions to copy at each vblank when the vblank callback is asynchronous
+static void watchMemory(u32 address, u32 size, lua_State *L)
+{
+	luaL_argcheck(L, GetMemPtr(address, size) != nullptr && size <= RAM_SIZE - (address & RAM_MASK), 1,
+			"region must be in system RAM");
+	vblankWorker.watch(address, size);
+}
+
+// Direct view of a system RAM region
+class MemoryView
+{
+public:
+	MemoryView() = default;
+	MemoryView(u32 address, u32 size, const u8 *data)
+		: address(address), size(size), data(data) {}
+
+	u32 getAddress() const { return address; }
+	u32 getSize() const { return size; }
+
+	template<typename T, typename R>
+	R read(u32 offset, lua_State *L) const
+	{
+		luaL_argcheck(L, offset + sizeof(T) <= size, 2, "offset out of range");
+		T v;
+		memcpy(&v, data + offset, sizeof(T));
+		return (R)v;
+	}
+
+private:
+	u32 address = 0;
+	u32 size = 0;
+	const u8 *data = nullptr;
+};
+
+static MemoryView newMemoryView(u32 address, u32 size, lua_State *L)
+{
+	const u8 *p = getRamPtr(address, size);
+	luaL_argcheck(L, p != nullptr, 1, "region must be in system RAM");
+	return MemoryView(address, size, p);
+}
+
+// Field offsets and types of a guest data structure
+class StructLayout
+{
+public:
+	struct Field
+	{
+		std::string name;
+		u32 offset;
+		MemType type;
+	};
+
+	void addField(const std::string& name, u32 offset, MemType type)
+	{
+		fields.push_back({ name, offset, type });
+		size = std::max(size, offset + memTypeSize(type));
+	}
+
+	// Reads all the fields of the structure at the given address. Returns a table.
+	LuaRef read(u32 address, lua_State *L) const
+	{
+		LuaRef t(L);
+		t = newTable(L);
+		const u8 *p = getRamPtr(address, size);
+		for (const Field& field : fields)
+			setMemValue(t, field.name, field.type, address + field.offset, p == nullptr ? nullptr : p + field.offset);
+		return t;
+	}
+
+	u32 getSize() const { return size; }
+
+private:
+	std::vector<Field> fields;
+	u32 size = 0;
+};
+
+// The layout is described by a table: { name = { offset, type }, ... }
+static StructLayout newStructLayout(LuaRef desc, lua_State *L)
+{
+	luaL_argcheck(L, desc.isTable(), 1, "table expected");
+	StructLayout layout;
+	for (Iterator it(desc); !it.isNil(); ++it)
+	{
+		LuaRef field = it.value();
+		luaL_argcheck(L, it.key().isString() && field.isTable() && field[1].isNumber() && field[2].isString(), 1,
+				"fields must be name = { offset, type }");
+		layout.addField(it.key().cast<std::string>(), field[1].cast<u32>(), parseMemType(field[2].cast<std::string>(), 1, L));
+	}
+	return layout;
+}
+
 #define CONFIG_ACCESSORS(Config) 	\
 template<typename T>				\
 static T get ## Config() {			\
@@ -144,7 +520,9 @@ static T get ## Config() {			\
 template<typename T>				\
 static void set ## Config(T v)		\
 {									\
-	config::Config.set(v);			\
+	runOnEmuThread([v]() {			\
+		config::Config.set(v);		\
+	});								\
 }
 
 // General
@@ -252,8 +630,10 @@ static void setMapleType(int bus, int type, lua_State *L)
 	case MDT_LightGun:
 	case MDT_TwinStick:
 	case MDT_None:
-		config::MapleMainDevices[bus - 1] = (MapleDeviceType)type;
-		maple_ReconnectDevices();
+		runOnEmuThread([bus, type]() {
+			config::MapleMainDevices[bus - 1] = (MapleDeviceType)type;
+			maple_ReconnectDevices();
+		});
 		break;
 	default:
 		luaL_argerror(L, 2, "Invalid device type");
@@ -270,8 +650,10 @@ static void setMapleSubType(int bus, int port, int type, lua_State *L)
 	case MDT_PurupuruPack:
 	case MDT_Microphone:
 	case MDT_None:
-		config::MapleExpansionDevices[bus - 1][port - 1] = (MapleDeviceType)type;
-		maple_ReconnectDevices();
+		runOnEmuThread([bus, port, type]() {
+			config::MapleExpansionDevices[bus - 1][port - 1] = (MapleDeviceType)type;
+			maple_ReconnectDevices();
+		});
 		break;
 	default:
 		luaL_argerror(L, 3, "Invalid device type");
@@ -294,13 +676,17 @@ static u32 getButtons(int player, lua_State *L)
 static void pressButtons(int player, u32 buttons, lua_State *L)
 {
 	checkPlayerNum(L, player);
-	kcode[player - 1] &= ~buttons;
+	runOnEmuThread([player, buttons]() {
+		kcode[player - 1] &= ~buttons;
+	});
 }
 
 static void releaseButtons(int player, u32 buttons, lua_State *L)
 {
 	checkPlayerNum(L, player);
-	kcode[player - 1] |= buttons;
+	runOnEmuThread([player, buttons]() {
+		kcode[player - 1] |= buttons;
+	});
 }
 
 static int getAxis(int player, int axis, lua_State *L)
@@ -330,29 +716,31 @@ static void setAxis(int player, int axis, int value, lua_State *L)
 {
 	checkPlayerNum(L, player);
 	luaL_argcheck(L, axis >= 1 && axis <= 6, 2, "axis must be between 1 and 6");
-	switch (axis - 1)
-	{
-	case 0:
-		joyx[player - 1] = value;
-		break;
-	case 1:
-		joyy[player - 1] = value;
-		break;
-	case 2:
-		joyrx[player - 1] = value;
-		break;
-	case 3:
-		joyry[player - 1] = value;
-		break;
-	case 4:
-		lt[player - 1] = value;
-		break;
-	case 5:
-		rt[player - 1] = value;
-		break;
-	default:
-		break;
-	}
+	runOnEmuThread([player, axis, value]() {
+		switch (axis - 1)
+		{
+		case 0:
+			joyx[player - 1] = value;
+			break;
+		case 1:
+			joyy[player - 1] = value;
+			break;
+		case 2:
+			joyrx[player - 1] = value;
+			break;
+		case 3:
+			joyry[player - 1] = value;
+			break;
+		case 4:
+			lt[player - 1] = value;
+			break;
+		case 5:
+			rt[player - 1] = value;
+			break;
+		default:
+			break;
+		}
+	});
 }
 
 static int getAbsCoordinates(lua_State *L)
@@ -367,7 +755,9 @@ static int getAbsCoordinates(lua_State *L)
 static void setAbsCoordinates(int player, int x, int y, lua_State *L)
 {
 	checkPlayerNum(L, player);
-	SetMousePosition(x, y, settings.display.width, settings.display.height, player - 1);
+	runOnEmuThread([player, x, y]() {
+		SetMousePosition(x, y, settings.display.width, settings.display.height, player - 1);
+	});
 }
 
 static int getRelCoordinates(lua_State *L)
@@ -382,7 +772,9 @@ static int getRelCoordinates(lua_State *L)
 static void setRelCoordinates(int player, float x, float y, lua_State *L)
 {
 	checkPlayerNum(L, player);
-	SetRelativeMousePosition(x, y, player - 1);
+	runOnEmuThread([player, x, y]() {
+		SetRelativeMousePosition(x, y, player - 1);
+	});
 }
 
 // UI
@@ -511,25 +903,25 @@ static int uiLine(float x1, float y1, float x2, float y2, u32 color)
 
 static int read8s(u32 addr)
 {
-	u8 data = _vmem_ReadMem8(addr);
+	u8 data = readMemory<u8>(addr);
 	return (s8)data;
 }
 
 static int read16s(u32 addr)
 {
-	u16 data = _vmem_ReadMem16(addr);
+	u16 data = readMemory<u16>(addr);
 	return (s16)data;
 }
 
 static int read32s(u32 addr)
 {
-	u32 data = _vmem_ReadMem32(addr);
+	u32 data = readMemory<u32>(addr);
 	return (s32)data;
 }
 
 static f32 read32f(u32 addr)
 {
-	u32 data = _vmem_ReadMem32(addr);
+	u32 data = readMemory<u32>(addr);
 	return *(f32 *)&data;
 }
 
@@ -540,12 +932,79 @@ static int getFrameNumber()
 
 static void loadRecordSlotsFile(std::string filename)
 {
-	dojo.LoadRecordSlotsFile(filename);
+	runOnEmuThread([filename]() {
+		dojo.LoadRecordSlotsFile(filename);
+	});
 }
 
 static void playRecordSlot(int slot)
 {
-	dojo.PlayRecording(slot);
+	runOnEmuThread([slot]() {
+		dojo.PlayRecording(slot);
+	});
+}
+
+static void startGame(const std::string& path)
+{
+	runOnEmuThread([path]() {
+		gui_start_game(path);
+	});
+}
+
+static void stopGame()
+{
+	runOnEmuThread([]() {
+		gui_stop_game("");
+	});
+}
+
+static void pauseEmu()
+{
+	runOnEmuThread([]() {
+		if (gui_state == GuiState::Closed)
+			gui_open_settings();
+	});
+}
+
+static void resumeEmu()
+{
+	runOnEmuThread([]() {
+		if (gui_state == GuiState::Commands)
+			gui_open_settings();
+	});
+}
+
+static void saveState(int index)
+{
+	runOnEmuThread([index]() {
+		bool restart = false;
+		if (gui_state == GuiState::Closed) {
+			gui_open_settings();
+			restart = true;
+		}
+		dc_savestate(index);
+		if (restart)
+			gui_open_settings();
+	});
+}
+
+static void loadState(int index)
+{
+	runOnEmuThread([index]() {
+		bool restart = false;
+		if (gui_state == GuiState::Closed) {
+			gui_open_settings();
+			restart = true;
+		}
+		dc_loadstate(index);
+		if (restart)
+			gui_open_settings();
+	});
+}
+
+static void exitEmu()
+{
+	runOnEmuThread(dc_exit);
 }
 
 static void luaRegister(lua_State *L)
@@ -553,37 +1012,13 @@ static void luaRegister(lua_State *L)
 	getGlobalNamespace(L)
 		.beginNamespace ("flycast")
 	  		.beginNamespace("emulator")
-				.addFunction("startGame", gui_start_game)	// FIXME threading!
-				.addFunction("stopGame", std::function<void()>([]() { gui_stop_game(""); }))
-				.addFunction("pause", std::function<void()>([]() {
-					if (gui_state == GuiState::Closed)
-						gui_open_settings();
-				}))
-				.addFunction("resume", std::function<void()>([]() {
-					if (gui_state == GuiState::Commands)
-						gui_open_settings();
-				}))
-				.addFunction("saveState", std::function<void(int)>([](int index) {
-					bool restart = false;
-					if (gui_state == GuiState::Closed) {
-						gui_open_settings();
-						restart = true;
-					}
-					dc_savestate(index);
-					if (restart)
-						gui_open_settings();
-				}))
-				.addFunction("loadState", std::function<void(int)>([](int index) {
-					bool restart = false;
-					if (gui_state == GuiState::Closed) {
-						gui_open_settings();
-						restart = true;
-					}
-					dc_loadstate(index);
-					if (restart)
-						gui_open_settings();
-				}))
-				.addFunction("exit", dc_exit)
+				.addFunction("startGame", startGame)	// FIXME threading!
+				.addFunction("stopGame", stopGame)
+				.addFunction("pause", pauseEmu)
+				.addFunction("resume", resumeEmu)
+				.addFunction("saveState", saveState)
+				.addFunction("loadState", loadState)
+				.addFunction("exit", exitEmu)
 				.addFunction("displayNotification", gui_display_notification)
 			.endNamespace()
 
@@ -679,10 +1114,10 @@ static void luaRegister(lua_State *L)
 			.endNamespace()
 
 	  		.beginNamespace("memory")
-				.addFunction("read8", _vmem_readt<u8, u8>)
-				.addFunction("read16", _vmem_readt<u16, u16>)
-				.addFunction("read32", _vmem_readt<u32, u32>)
-				.addFunction("read64", _vmem_readt<u64, u64>)
+				.addFunction("read8", readMemory<u8>)
+				.addFunction("read16", readMemory<u16>)
+				.addFunction("read32", readMemory<u32>)
+				.addFunction("read64", readMemory<u64>)
 				.addFunction("read8s", read8s)
 				.addFunction("read16s", read16s)
 				.addFunction("read32s", read32s)
@@ -691,10 +1126,30 @@ static void luaRegister(lua_State *L)
 				.addFunction("readTable16", readMemoryTable<u16>)
 				.addFunction("readTable32", readMemoryTable<u32>)
 				.addFunction("readTable64", readMemoryTable<u64>)
-				.addFunction("write8", _vmem_writet<u8>)
-				.addFunction("write16", _vmem_writet<u16>)
-				.addFunction("write32", _vmem_writet<u32>)
-				.addFunction("write64", _vmem_writet<u64>)
+				.addFunction("write8", writeMemory<u8>)
+				.addFunction("write16", writeMemory<u16>)
+				.addFunction("write32", writeMemory<u32>)
+				.addFunction("write64", writeMemory<u64>)
+				.addFunction("watch", watchMemory)
+				.addFunction("readMany", readMany)
+				.addFunction("view", newMemoryView)
+				.addFunction("struct", newStructLayout)
+				.beginClass<MemoryView>("View")
+					.addProperty("address", &MemoryView::getAddress)
+					.addProperty("size", &MemoryView::getSize)
+					.addFunction("read8", &MemoryView::read<u8, u32>)
+					.addFunction("read16", &MemoryView::read<u16, u32>)
+					.addFunction("read32", &MemoryView::read<u32, u32>)
+					.addFunction("read64", &MemoryView::read<u64, u64>)
+					.addFunction("read8s", &MemoryView::read<s8, int>)
+					.addFunction("read16s", &MemoryView::read<s16, int>)
+					.addFunction("read32s", &MemoryView::read<s32, int>)
+					.addFunction("read32f", &MemoryView::read<f32, f32>)
+				.endClass()
+				.beginClass<StructLayout>("Struct")
+					.addProperty("size", &StructLayout::getSize)
+					.addFunction("read", &StructLayout::read)
+				.endClass()
 			.endNamespace()
 
 			.beginNamespace("input")
@@ -800,6 +1255,7 @@ void term()
     EventManager::unlisten(Event::Terminate, emuEventCallback);
     EventManager::unlisten(Event::LoadState, emuEventCallback);
     EventManager::unlisten(Event::VBlank, emuEventCallback);
+	vblankWorker.stop();
 	lua_close(L);
 	L = nullptr;
 }
@@ -23,6 +23,7 @@
 #include "input/keyboard_device.h"
 #include "input/mouse.h"
 #include "cfg/option.h"
+#include "profiler/latency.h"
 #include "version.h"
 #include <algorithm>
 #include <dojo/DojoSession.hpp>
@@ -37,7 +38,10 @@ bool inRollback;
 static void getLocalInput(MapleInputState inputState[4])
 {
 	if (!config::ThreadedRendering)
+	{
 		UpdateInputState();
+		latency::poll();
+	}
 	std::lock_guard<std::mutex> lock(relPosMutex);
 	for (int player = 0; player < 4; player++)
 	{
@@ -132,11 +136,13 @@ struct MemPages
 		memwatch::vramWatcher.getPages(vram);
 		memwatch::aramWatcher.getPages(aram);
 		memwatch::elanWatcher.getPages(elanram);
+		memwatch::bufferWatcher.getPages(buffers);
 	}
 	memwatch::PageMap ram;
 	memwatch::PageMap vram;
 	memwatch::PageMap aram;
 	memwatch::PageMap elanram;
+	memwatch::PageMap buffers;
 };
 static std::unordered_map<int, MemPages> deltaStates;
 static int lastSavedFrame = -1;
@@ -298,6 +304,12 @@ static bool load_game_state(unsigned char *buffer, int len)
 			memcpy(memwatch::aramWatcher.getMemPage(pair.first), &pair.second.data[0], PAGE_SIZE);
 		for (const auto& pair : pages.elanram)
 			memcpy(memwatch::elanWatcher.getMemPage(pair.first), &pair.second.data[0], PAGE_SIZE);
+		for (const auto& pair : pages.buffers)
+		{
+			void *page = memwatch::bufferWatcher.getMemPage(pair.first);
+			if (page != nullptr)
+				memcpy(page, &pair.second.data[0], PAGE_SIZE);
+		}
 		DEBUG_LOG(NETWORK, "Restored frame %d pages: %d ram, %d vram, %d eram, %d aica ram", f, (u32)pages.ram.size(),
 					(u32)pages.vram.size(), (u32)pages.elanram.size(), (u32)pages.aram.size());
 	}
@@ -697,7 +709,10 @@ bool nextFrame()
 	// may call save_game_state
 	do {
 		if (!config::ThreadedRendering)
+		{
 			UpdateInputState();
+			latency::poll();
+		}
 		Inputs inputs;
 		inputs.kcode = ~kcode[0];
 		if (rt[0] >= 64)
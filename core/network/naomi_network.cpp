@@ -87,6 +87,11 @@ bool NaomiNetwork::startNetwork()
 	slotId = 0;
 	slotCount = 0;
 	slaves.clear();
+	ringHead = 0;
+	ringTail = 0;
+	readOffset = 0;
+	receiveFailed = false;
+	receiveError = nullptr;
 
 	using namespace std::chrono;
 
@@ -263,13 +268,23 @@ bool NaomiNetwork::receive(const sockaddr_in *addr, const Packet *packet, u32 si
 		break;
 
 	case Data:
-		if (!receivedData.empty())
-			INFO_LOG(NETWORK, "Received packet overwritten");
-		receivedData.resize(size - packet->size(0));
-		memcpy(receivedData.data(), packet->data.payload, receivedData.size());
-		packetNumber = packet->data.packetNumber;
-		// TODO? sendAck(peer, port);
-		return true;
+		{
+			const u32 head = ringHead.load(std::memory_order_relaxed);
+			if (head - ringTail.load(std::memory_order_acquire) == RingSize)
+			{
+				INFO_LOG(NETWORK, "Receive ring full. Packet dropped");
+				return false;
+			}
+			RingSlot& slot = ring[head % RingSize];
+			if (&slot.packet != packet)
+				// Not received in place (handshake or another packet type received before)
+				memcpy(&slot.packet, packet, size);
+			slot.size = size - packet->size(0);
+			if (slot.size > 0)
+				ringHead.store(head + 1, std::memory_order_release);
+			// TODO? sendAck(peer, port);
+			return true;
+		}
 
 	case Ack:
 		break;
@@ -288,6 +303,116 @@ bool NaomiNetwork::receive(const sockaddr_in *addr, const Packet *packet, u32 si
 	return false;
 }
 
+void NaomiNetwork::startReceiveThread()
+{
+	receiverStopping = false;
+	receiverThread = std::thread(&NaomiNetwork::receiveThread, this);
+}
+
+void NaomiNetwork::stopReceiveThread()
+{
+	receiverStopping = true;
+	if (receiverThread.joinable())
+		receiverThread.join();
+	receiverStopping = false;
+}
+
+void NaomiNetwork::receiveThread()
+{
+	try {
+		while (!receiverStopping)
+		{
+			const u32 head = ringHead.load(std::memory_order_relaxed);
+			const u32 freeSlots = RingSize - (head - ringTail.load(std::memory_order_acquire));
+			if (freeSlots == 0)
+			{
+				// The emulation thread is lagging behind
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
+			}
+			// Wake up regularly to check if we must stop
+			fd_set readFds;
+			FD_ZERO(&readFds);
+			FD_SET(sock, &readFds);
+			timeval tv { 0, 10000 };
+			int rc = select((int)sock + 1, &readFds, nullptr, nullptr, &tv);
+			if (rc == -1)
+			{
+				int error = get_last_error_n();
+#ifndef _WIN32
+				if (error == EINTR)
+					continue;
+#endif
+				throw Exception("Select error: errno " + std::to_string(error));
+			}
+			if (rc == 1)
+				receiveBatch(head, freeSlots);
+		}
+	} catch (const FlycastException& e) {
+		ERROR_LOG(NETWORK, "%s", e.what());
+		receiveError = std::current_exception();
+		receiveFailed.store(true, std::memory_order_release);
+	}
+}
+
+// Receive all pending packets (up to freeSlots) directly into the ring
+void NaomiNetwork::receiveBatch(u32 head, u32 freeSlots)
+{
+	auto checkError = []() {
+		int error = get_last_error_n();
+		if (error == L_EWOULDBLOCK || error == L_EAGAIN)
+			return;
+#ifdef _WIN32
+		if (error == WSAECONNRESET)
+			// Happens if the previous send resulted in an ICMP Port Unreachable message
+			return;
+#endif
+		throw Exception("Receive error: errno " + std::to_string(error));
+	};
+	auto received = [this](RingSlot& slot, u32 size) {
+		if (size < slot.packet.size(0))
+			throw Exception("Receive error: truncated packet");
+		receive(&slot.addr, &slot.packet, size);
+	};
+#ifdef __linux__
+	// Single syscall for the whole batch
+	mmsghdr msgs[RingSize];
+	iovec iovs[RingSize];
+	for (u32 i = 0; i < freeSlots; i++)
+	{
+		RingSlot& slot = ring[(head + i) % RingSize];
+		iovs[i].iov_base = &slot.packet;
+		iovs[i].iov_len = sizeof(slot.packet);
+		msgs[i].msg_hdr = {};
+		msgs[i].msg_hdr.msg_name = &slot.addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(slot.addr);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+	int count = recvmmsg(sock, msgs, freeSlots, MSG_DONTWAIT, nullptr);
+	if (count == -1)
+	{
+		checkError();
+		return;
+	}
+	for (int i = 0; i < count; i++)
+		received(ring[(head + i) % RingSize], msgs[i].msg_len);
+#else
+	for (u32 i = 0; i < freeSlots; i++)
+	{
+		RingSlot& slot = ring[(head + i) % RingSize];
+		socklen_t len = sizeof(slot.addr);
+		int rc = recvfrom(sock, (char *)&slot.packet, sizeof(slot.packet), 0, (sockaddr *)&slot.addr, &len);
+		if (rc == -1)
+		{
+			checkError();
+			break;
+		}
+		received(slot, rc);
+	}
+#endif
+}
+
 // Sets the game network config using MIE eeprom or bbsram:
 // Node -1 disables network
 // Node 0 is master, nodes 1+ are slave
@@ -25,7 +25,9 @@
 
 #include <algorithm>
 #include <atomic>
+#include <exception>
 #include <future>
+#include <thread>
 #include <vector>
 
 class NaomiNetwork
@@ -45,6 +47,8 @@ public:
 		_startNow = false;
 		return std::async(std::launch::async, [this] {
 			bool res = startNetwork();
+			if (res)
+				startReceiveThread();
 			emu.setNetworkState(res);
 			return res;
 		});
@@ -54,20 +58,37 @@ public:
 	{
 		enableNetworkBroadcast(false);
 		emu.setNetworkState(false);
+		stopReceiveThread();
 		closesocket(sock);
 		sock = INVALID_SOCKET;
 	}
 
 	bool receive(u8 *data, u32 size, u16 *packetNumber)
 	{
-		poll();
-		if (receivedData.empty())
+		if (receiveFailed.load(std::memory_order_acquire))
+			std::rethrow_exception(receiveError);
+		u32 tail = ringTail.load(std::memory_order_relaxed);
+		const u32 head = ringHead.load(std::memory_order_acquire);
+		if (head == tail)
 			return false;
-
-		size = std::min(size, (u32)receivedData.size());
-		memcpy(data, receivedData.data(), size);
-		receivedData.erase(receivedData.begin(), receivedData.begin() + size);
-		*packetNumber = this->packetNumber;
+		if (head - tail > 1)
+		{
+			// Only the most recent packet is relevant
+			INFO_LOG(NETWORK, "Received packet overwritten");
+			tail = head - 1;
+			readOffset = 0;
+		}
+		const RingSlot& slot = ring[tail % RingSize];
+		size = std::min(size, slot.size - readOffset);
+		memcpy(data, slot.packet.data.payload + readOffset, size);
+		readOffset += size;
+		*packetNumber = slot.packet.data.packetNumber;
+		if (readOffset == slot.size)
+		{
+			readOffset = 0;
+			tail++;
+		}
+		ringTail.store(tail, std::memory_order_release);
 
 		return true;
 	}
@@ -175,6 +196,11 @@ private:
 
 	bool receive(const sockaddr_in *addr, const Packet *packet, u32 size);
 
+	void startReceiveThread();
+	void stopReceiveThread();
+	void receiveThread();
+	void receiveBatch(u32 head, u32 freeSlots);
+
 	void sendAck(const sockaddr_in *addr, bool ack = true)
 	{
 		Packet packet(ack ? Ack : NAck);
@@ -197,10 +223,26 @@ private:
 	MiniUPnP miniupnp;
 
 	sockaddr_in nextPeer;
-	std::vector<u8> receivedData;
-	u16 packetNumber = 0;
 	bool _startNow = false;
 
+	// Once the game has started, packets are received by a dedicated thread
+	// into a single-producer single-consumer ring.
+	struct RingSlot
+	{
+		Packet packet;
+		sockaddr_in addr;
+		u32 size;	// payload size
+	};
+	static constexpr u32 RingSize = 8;
+	RingSlot ring[RingSize];
+	std::atomic<u32> ringHead{ 0 };	// written by the receive thread
+	std::atomic<u32> ringTail{ 0 };	// written by the emulation thread
+	u32 readOffset = 0;
+	std::thread receiverThread;
+	std::atomic<bool> receiverStopping{ false };
+	std::atomic<bool> receiveFailed{ false };
+	std::exception_ptr receiveError;
+
 	// Server stuff
 	struct Slave
 	{
@@ -51,10 +51,13 @@ extern "C" {
 #include "cfg/option.h"
 #include "emulator.h"
 
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <queue>
 #include <future>
+#include <thread>
 
 #define RESOLVER1_OPENDNS_COM "208.67.222.222"
 #define AFO_ORIG_IP 0x83f2fb3f		// 63.251.242.131 in network order
@@ -244,7 +247,32 @@ static bool pico_stack_inited;
 static bool pico_thread_running = false;
 extern "C" int dont_reject_opt_vj_hack;
 
-static void read_native_sockets();
+// Loopback udp socket used to wake up the pico thread when the modem or BBA has data for it
+static std::atomic<sock_t> wakeup_sock { INVALID_SOCKET };
+static std::atomic<bool> wakeup_pending;
+// Wait at most this long for an event so that pico timers are serviced
+constexpr int MaxWaitTime = 5; // ms
+
+static void wakeup_pico_thread()
+{
+	if (!wakeup_pending.exchange(true))
+	{
+		sock_t sock = wakeup_sock;
+		if (VALID(sock))
+		{
+			char c = 0;
+			send(sock, &c, 1, 0);
+		}
+	}
+}
+
+struct NativeEvents
+{
+	fd_set read_fds;
+	fd_set write_fds;
+	fd_set error_fds;
+};
+static void read_native_sockets(NativeEvents& events);
 void get_host_by_name(const char *name, pico_ip4 dnsaddr);
 int get_dns_answer(pico_ip4 *address, pico_ip4 dnsaddr);
 
@@ -277,7 +305,7 @@ static int modem_write(pico_device *dev, const void *data, int len)
 			in_buffer_lock.unlock();
 			if (!pico_thread_running)
 				return 0;
-			PICO_IDLE();
+			std::this_thread::sleep_for(std::chrono::milliseconds(MaxWaitTime));
 			in_buffer_lock.lock();
 		}
 		in_buffer.push(*p++);
@@ -292,6 +320,7 @@ void write_pico(u8 b)
 	out_buffer_lock.lock();
 	out_buffer.push(b);
 	out_buffer_lock.unlock();
+	wakeup_pico_thread();
 }
 
 int read_pico()
@@ -526,7 +555,96 @@ static void udp_callback(uint16_t ev, pico_socket *s)
 	}
 }
 
-static void read_native_sockets()
+static void create_wakeup_socket()
+{
+	wakeup_pending = false;
+	sock_t sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (!VALID(sock))
+	{
+		perror("wakeup socket");
+		return;
+	}
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addr_len = sizeof(addr);
+	// Bind to any port and connect to ourselves
+	if (::bind(sock, (sockaddr *)&addr, addr_len) < 0
+			|| getsockname(sock, (sockaddr *)&addr, &addr_len) < 0
+			|| connect(sock, (sockaddr *)&addr, addr_len) < 0)
+	{
+		perror("wakeup socket bind/connect");
+		closesocket(sock);
+		return;
+	}
+	set_non_blocking(sock);
+	wakeup_sock = sock;
+}
+
+static void close_wakeup_socket()
+{
+	sock_t sock = wakeup_sock.exchange(INVALID_SOCKET);
+	if (VALID(sock))
+		closesocket(sock);
+}
+
+// Wait until a native socket is ready, the modem or BBA has data or the next pico tick is due
+static void wait_native_sockets(NativeEvents& events)
+{
+	FD_ZERO(&events.read_fds);
+	FD_ZERO(&events.write_fds);
+	FD_ZERO(&events.error_fds);
+	int max_fd = -1;
+	auto addRead = [&](sock_t fd) {
+		FD_SET(fd, &events.read_fds);
+		max_fd = std::max(max_fd, (int)fd);
+	};
+	const sock_t wakeup = wakeup_sock;
+	if (VALID(wakeup))
+		addRead(wakeup);
+	for (const auto& it : tcp_listening_sockets)
+		addRead(it.second);
+	for (const auto& it : tcp_connecting_sockets)
+	{
+		FD_SET(it.second, &events.write_fds);
+		FD_SET(it.second, &events.error_fds);
+		max_fd = std::max(max_fd, (int)it.second);
+	}
+	for (const auto& it : udp_sockets)
+		if (VALID(it.second))
+			addRead(it.second);
+	// Sockets with data waiting to be sent to the dreamcast are serviced on each iteration.
+	// They will be unblocked by data coming from the modem or BBA.
+	for (const auto& it : tcp_sockets)
+		if (it.second.in_buffer.empty() && it.second.native_sock != INVALID_SOCKET)
+			addRead(it.second.native_sock);
+	if (max_fd == -1)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(MaxWaitTime));
+		return;
+	}
+	timeval tv { 0, MaxWaitTime * 1000 };
+	int rc = select(max_fd + 1, &events.read_fds, &events.write_fds, &events.error_fds, &tv);
+	if (rc == -1)
+	{
+		perror("select");
+		FD_ZERO(&events.read_fds);
+		FD_ZERO(&events.write_fds);
+		FD_ZERO(&events.error_fds);
+		return;
+	}
+	if (VALID(wakeup) && FD_ISSET(wakeup, &events.read_fds))
+	{
+		char buf[64];
+		while (recv(wakeup, buf, sizeof(buf), 0) > 0)
+			;
+		// Only clear the flag once drained, or the byte sent by a concurrent wake-up would be lost
+		// and all the subsequent wake-ups suppressed.
+		wakeup_pending = false;
+	}
+}
+
+static void read_native_sockets(NativeEvents& events)
 {
 	int r;
 	sockaddr_in src_addr;
@@ -535,6 +653,8 @@ static void read_native_sockets()
 	// Accept incoming TCP connections
 	for (auto it = tcp_listening_sockets.begin(); it != tcp_listening_sockets.end(); it++)
 	{
+		if (!FD_ISSET(it->second, &events.read_fds))
+			continue;
 		addr_len = sizeof(src_addr);
 		memset(&src_addr, 0, addr_len);
 		sock_t sockfd = accept(it->second, (sockaddr *)&src_addr, &addr_len);
@@ -571,98 +691,83 @@ static void read_native_sockets()
 	}
 
 	// Check connecting outbound TCP sockets
-	fd_set write_fds{};
-	fd_set error_fds{};
-	FD_ZERO(&write_fds);
-	FD_ZERO(&error_fds);
-	int max_fd = -1;
-	for (auto it = tcp_connecting_sockets.begin(); it != tcp_connecting_sockets.end(); it++)
-	{
-		FD_SET(it->second, &write_fds);
-		FD_SET(it->second, &error_fds);
-		max_fd = std::max(max_fd, (int)it->second);
-	}
-	if (max_fd > -1)
+	for (auto it = tcp_connecting_sockets.begin(); it != tcp_connecting_sockets.end(); )
 	{
-		timeval tv{};
-		int rc = select(max_fd + 1, nullptr, &write_fds, &error_fds, &tv);
-		if (rc == -1)
-			perror("select");
-		else if (rc > 0)
+		if (!FD_ISSET(it->second, &events.write_fds) && !FD_ISSET(it->second, &events.error_fds))
 		{
-			for (auto it = tcp_connecting_sockets.begin(); it != tcp_connecting_sockets.end(); )
-			{
-				if (!FD_ISSET(it->second, &write_fds) && !FD_ISSET(it->second, &error_fds))
-				{
-					it++;
-					continue;
-				}
-				int error;
+			it++;
+			continue;
+		}
+		int error;
 #ifdef _WIN32
-				char *value = (char *)&error;
+		char *value = (char *)&error;
 #else
-				int *value = &error;
+		int *value = &error;
 #endif
-				socklen_t l = sizeof(int);
-				if (getsockopt(it->second, SOL_SOCKET, SO_ERROR, value, &l) < 0 || error != 0)
-				{
-					char peer[30];
-					pico_ipv4_to_string(peer, it->first->local_addr.ip4.addr);
-					INFO_LOG(MODEM, "TCP connection to %s:%d failed: %s", peer, short_be(it->first->local_port), strerror(get_last_error_n()));
-					pico_socket_close(it->first);
-					closesocket(it->second);
-				}
-				else
-				{
-					set_tcp_nodelay(it->second);
+		socklen_t l = sizeof(int);
+		if (getsockopt(it->second, SOL_SOCKET, SO_ERROR, value, &l) < 0 || error != 0)
+		{
+			char peer[30];
+			pico_ipv4_to_string(peer, it->first->local_addr.ip4.addr);
+			INFO_LOG(MODEM, "TCP connection to %s:%d failed: %s", peer, short_be(it->first->local_port), strerror(get_last_error_n()));
+			pico_socket_close(it->first);
+			closesocket(it->second);
+		}
+		else
+		{
+			set_tcp_nodelay(it->second);
 
-					tcp_sockets.emplace(std::piecewise_construct,
-				              std::forward_as_tuple(it->first),
-				              std::forward_as_tuple(it->first, it->second));
+			tcp_sockets.emplace(std::piecewise_construct,
+		              std::forward_as_tuple(it->first),
+		              std::forward_as_tuple(it->first, it->second));
 
-					read_from_dc_socket(it->first, it->second);
-				}
-				it = tcp_connecting_sockets.erase(it);
-			}
+			read_from_dc_socket(it->first, it->second);
 		}
+		it = tcp_connecting_sockets.erase(it);
 	}
 
 	static char buf[1500];
 	pico_msginfo msginfo;
 
-	// Read UDP sockets
+	// Read UDP sockets. Drain each ready socket, up to a limit so that other sockets aren't starved.
 	for (auto it = udp_sockets.begin(); it != udp_sockets.end(); it++)
 	{
-		if (!VALID(it->second))
+		if (!VALID(it->second) || !FD_ISSET(it->second, &events.read_fds))
 			continue;
 
-		addr_len = sizeof(src_addr);
-		memset(&src_addr, 0, addr_len);
-		r = (int)recvfrom(it->second, buf, sizeof(buf), 0, (sockaddr *)&src_addr, &addr_len);
-		// filter out messages coming from ourselves (happens for broadcasts)
-		if (r > 0 && !is_local_address(src_addr.sin_addr.s_addr))
+		for (int i = 0; i < 16; i++)
 		{
-			msginfo.dev = pico_dev;
-			msginfo.tos = 0;
-			msginfo.ttl = 0;
-			msginfo.local_addr.ip4.addr = src_addr.sin_addr.s_addr;
-			msginfo.local_port = src_addr.sin_port;
-
-			int r2 = pico_socket_sendto_extended(pico_udp_socket, buf, r, &dcaddr, it->first, &msginfo);
-			if (r2 < r)
-				INFO_LOG(MODEM, "error UDP sending to %d: %s", short_be(it->first), strerror(pico_err));
-		}
-		else if (r < 0 && get_last_error_n() != L_EAGAIN && get_last_error_n() != L_EWOULDBLOCK)
-		{
-			perror("recvfrom udp socket");
-			continue;
+			addr_len = sizeof(src_addr);
+			memset(&src_addr, 0, addr_len);
+			r = (int)recvfrom(it->second, buf, sizeof(buf), 0, (sockaddr *)&src_addr, &addr_len);
+			if (r < 0)
+			{
+				if (get_last_error_n() != L_EAGAIN && get_last_error_n() != L_EWOULDBLOCK)
+					perror("recvfrom udp socket");
+				break;
+			}
+			// filter out messages coming from ourselves (happens for broadcasts)
+			if (r > 0 && !is_local_address(src_addr.sin_addr.s_addr))
+			{
+				msginfo.dev = pico_dev;
+				msginfo.tos = 0;
+				msginfo.ttl = 0;
+				msginfo.local_addr.ip4.addr = src_addr.sin_addr.s_addr;
+				msginfo.local_port = src_addr.sin_port;
+
+				int r2 = pico_socket_sendto_extended(pico_udp_socket, buf, r, &dcaddr, it->first, &msginfo);
+				if (r2 < r)
+					INFO_LOG(MODEM, "error UDP sending to %d: %s", short_be(it->first), strerror(pico_err));
+			}
 		}
 	}
 
 	// Read TCP sockets
 	for (auto it = tcp_sockets.begin(); it != tcp_sockets.end(); )
 	{
-		it->second.receive_native();
+		if (!it->second.in_buffer.empty() || it->second.native_sock == INVALID_SOCKET
+				|| FD_ISSET(it->second.native_sock, &events.read_fds))
+			it->second.receive_native();
 		if (it->second.pico_sock == nullptr)
 			it = tcp_sockets.erase(it);
 		else
@@ -817,7 +922,10 @@ void pico_receive_eth_frame(const u8 *frame, u32 size)
 {
 	dumpFrame(frame, size);
 	if (pico_dev != nullptr)
+	{
 		pico_stack_recv(pico_dev, (u8 *)frame, size);
+		wakeup_pico_thread();
+	}
 }
 
 static int send_eth_frame(pico_device *dev, void *data, int len)
@@ -1030,12 +1138,14 @@ static void *pico_thread_func(void *)
 		}
 	}
 
+	create_wakeup_socket();
+	NativeEvents events;
 	while (pico_thread_running)
     {
-    	read_native_sockets();
+		wait_native_sockets(events);
+    	read_native_sockets(events);
     	pico_stack_tick();
     	check_dns_entries();
-		PICO_IDLE();
     }
 
 	for (auto it = tcp_listening_sockets.begin(); it != tcp_listening_sockets.end(); it++)
@@ -1082,7 +1192,9 @@ void stop_pico()
 {
 	emu.setNetworkState(false);
 	pico_thread_running = false;
+	wakeup_pico_thread();
 	pico_thread.WaitToEnd();
+	close_wakeup_socket();
 }
 
 // picotcp mutex implementation
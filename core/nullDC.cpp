@@ -18,6 +18,10 @@
 #include "dojo/DojoSession.hpp"
 #include "dojo/deps/filesystem.hpp"
 
+#include <future>
+#include <mutex>
+#include <vector>
+
 int flycast_init(int argc, char* argv[])
 {
 #if defined(TEST_AUTOMATION)
@@ -161,65 +165,82 @@ void dc_savestate(std::string filename)
 	dc_savestate(0, filename);
 }
 
-void dc_savestate(int index, std::string filename)
-{
-	if (settings.network.online)
-		return;
-
-	Serializer ser;
-	dc_serialize(ser);
-
-	void *data = malloc(ser.size());
-	if (data == nullptr)
-	{
-		WARN_LOG(SAVESTATE, "Failed to save state - could not malloc %d bytes", (int)ser.size());
-		gui_display_notification("Save state failed - memory full", 2000);
-    	return;
-	}
-
-	ser = Serializer(data, ser.size());
-	dc_serialize(ser);
+// Savestates are serialized into a reusable buffer then compressed and written
+// to disk by a background task
+static std::vector<u8> savestateBuffer;
+static std::future<void> savestateTask;
+// Savestates can be started and waited for from the UI, emulation or JNI threads
+static std::mutex savestateMutex;
 
-	if (filename.length() == 0)
-		filename = hostfs::getSavestatePath(index, true);
-#if 0
-	FILE *f = nowide::fopen(filename.c_str(), "wb");
+// savestateMutex must be held
+static void waitSavestate()
+{
+	if (savestateTask.valid())
+		savestateTask.get();
+}
 
-	if ( f == NULL )
-	{
-		WARN_LOG(SAVESTATE, "Failed to save state - could not open %s for writing", filename.c_str());
-		gui_display_notification("Cannot open save file", 2000);
-		free(data);
-    	return;
-	}
+void dc_waitSavestate()
+{
+	std::lock_guard<std::mutex> _(savestateMutex);
+	waitSavestate();
+}
 
-	std::fwrite(data, 1, ser.size(), f);
-	std::fclose(f);
-#else
+static void writeSavestate(std::string filename, size_t size)
+{
 	RZipFile zipFile;
 	if (!zipFile.Open(filename, true))
 	{
 		WARN_LOG(SAVESTATE, "Failed to save state - could not open %s for writing", filename.c_str());
 		gui_display_notification("Cannot open save file", 2000);
-		free(data);
-    	return;
+		return;
 	}
-	if (zipFile.Write(data, ser.size()) != ser.size())
+	if (zipFile.Write(savestateBuffer.data(), size) != size)
 	{
 		WARN_LOG(SAVESTATE, "Failed to save state - error writing %s", filename.c_str());
 		gui_display_notification("Error saving state", 2000);
 		zipFile.Close();
-		free(data);
-    	return;
+		return;
 	}
 	zipFile.Close();
-#endif
 
-	free(data);
-	NOTICE_LOG(SAVESTATE, "Saved state to %s size %d", filename.c_str(), (int)ser.size());
+	NOTICE_LOG(SAVESTATE, "Saved state to %s size %d", filename.c_str(), (int)size);
 	gui_display_notification("State saved", 1000);
 }
 
+void dc_savestate(int index, std::string filename)
+{
+	if (settings.network.online)
+		return;
+
+	std::lock_guard<std::mutex> _(savestateMutex);
+	// The buffer is still in use by the previous save
+	waitSavestate();
+
+	Serializer ser(savestateBuffer.data(), savestateBuffer.size());
+	dc_serialize(ser);
+	if (ser.overflow())
+	{
+		// Only happens the first time or if the state grows
+		try {
+			savestateBuffer.resize(ser.size());
+		} catch (const std::bad_alloc&) {
+			WARN_LOG(SAVESTATE, "Failed to save state - could not malloc %d bytes", (int)ser.size());
+			gui_display_notification("Save state failed - memory full", 2000);
+			return;
+		}
+		ser = Serializer(savestateBuffer.data(), savestateBuffer.size());
+		dc_serialize(ser);
+		verify(!ser.overflow());
+	}
+
+	if (filename.length() == 0)
+		filename = hostfs::getSavestatePath(index, true);
+	size_t size = ser.size();
+	savestateTask = std::async(std::launch::async, [filename, size]() {
+		writeSavestate(filename, size);
+	});
+}
+
 void jump_state()
 {
 	if (dojo.PlayMatch && dojo.replay_version < 2)
@@ -251,6 +272,7 @@ void dc_loadstate(int index, std::string filename)
 	FILE *f = nullptr;
 
 	emu.stop();
+	dc_waitSavestate();
 
 	if (filename.length() == 0)
 		filename = hostfs::getSavestatePath(index, false);
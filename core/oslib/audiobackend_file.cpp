@@ -0,0 +1,245 @@
+/*
+	Audio backend that streams the emulator output to a WAV or raw PCM file.
+	Useful to capture audio in headless runs and to compare the output of the audio path deterministically.
+	Samples are written to disk by a separate thread.
+*/
+#include "audiostream.h"
+#include "cfg/cfg.h"
+#include "oslib/oslib.h"
+#include "rend/mainui.h"
+#include "stdclass.h"
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <thread>
+
+class FileAudioBackend : public AudioBackend
+{
+	using the_clock = std::chrono::high_resolution_clock;
+
+	struct Timestamp
+	{
+		u64 sample;		// index of the first sample of the block
+		u32 frame;		// emulator frame number
+		u64 hostTime;	// microseconds
+	};
+
+	FILE *file = nullptr;
+	FILE *tsFile = nullptr;
+	bool wav = true;
+	bool realtime = false;
+	u64 sampleCount = 0;
+	u32 dataSize = 0;
+	bool fileFull = false;
+	u32 lostTimestamps = 0;
+
+	RingBuffer ringBuffer;
+	RingBuffer tsBuffer;
+	std::thread writerThread;
+	std::atomic_bool running { false };
+	cResetEvent dataAvailable;
+	cResetEvent spaceAvailable;
+	the_clock::time_point last_time;
+
+	static void writeWavHeader(FILE *f, u32 dataSize)
+	{
+		struct {
+			char riff[4] = { 'R', 'I', 'F', 'F' };
+			u32 riffSize;
+			char wave[4] = { 'W', 'A', 'V', 'E' };
+			char fmt[4] = { 'f', 'm', 't', ' ' };
+			u32 fmtSize = 16;
+			u16 format = 1;			// PCM
+			u16 channels = 2;
+			u32 sampleRate = 44100;
+			u32 byteRate = 44100 * 4;
+			u16 blockAlign = 4;
+			u16 bitsPerSample = 16;
+			char data[4] = { 'd', 'a', 't', 'a' };
+			u32 dataSize;
+		} header;
+		static_assert(sizeof(header) == 44, "Invalid WAV header size");
+		header.riffSize = dataSize + sizeof(header) - 8;
+		header.dataSize = dataSize;
+		std::fseek(f, 0, SEEK_SET);
+		std::fwrite(&header, sizeof(header), 1, f);
+	}
+
+	// Write the buffered samples by whole blocks, or everything if final is true
+	void drain(bool final = false)
+	{
+		u8 buf[SAMPLE_COUNT * 4];
+		while (ringBuffer.readSize() >= sizeof(buf))
+		{
+			ringBuffer.read(buf, sizeof(buf));
+			spaceAvailable.Set();
+			writeSamples(buf, sizeof(buf));
+		}
+		const u32 remaining = ringBuffer.readSize();
+		if (final && remaining > 0)
+		{
+			ringBuffer.read(buf, remaining);
+			writeSamples(buf, remaining);
+		}
+		if (tsFile != nullptr)
+		{
+			Timestamp ts;
+			while (tsBuffer.read((u8 *)&ts, sizeof(ts)))
+				std::fprintf(tsFile, "%" PRIu64 ",%u,%" PRIu64 "\n", ts.sample, ts.frame, ts.hostTime);
+		}
+	}
+
+	void writeSamples(const u8 *data, u32 size)
+	{
+		if (wav)
+		{
+			// The WAV data size is 32-bit and the RIFF size includes the rest of the header
+			constexpr u32 MaxDataSize = (0xffffffffu - 36) & ~3u;
+			if (size > MaxDataSize - dataSize)
+			{
+				if (!fileFull)
+					WARN_LOG(AUDIO, "WAV file size limit reached: audio recording stopped");
+				fileFull = true;
+				return;
+			}
+		}
+		std::fwrite(data, size, 1, file);
+		dataSize += size;
+	}
+
+	void writerMain()
+	{
+		while (running)
+		{
+			dataAvailable.Wait(100);
+			drain();
+		}
+		drain(true);
+	}
+
+public:
+	FileAudioBackend()
+		: AudioBackend("file", "WAV/Raw File Output") {}
+
+	bool init() override
+	{
+		wav = cfgLoadStr("file", "format", "wav") != "raw";
+		realtime = cfgLoadBool("file", "realtime", false);
+		std::string path = cfgLoadStr("file", "path", "");
+		if (path.empty())
+			path = get_writable_data_path(wav ? "flycast-audio.wav" : "flycast-audio.raw");
+
+		file = nowide::fopen(path.c_str(), "wb");
+		if (file == nullptr)
+		{
+			ERROR_LOG(AUDIO, "Can't create audio file %s", path.c_str());
+			return false;
+		}
+		dataSize = 0;
+		fileFull = false;
+		sampleCount = 0;
+		lostTimestamps = 0;
+		if (wav)
+			writeWavHeader(file, 0);
+		if (cfgLoadBool("file", "timestamps", false))
+		{
+			std::string tsPath = path + ".timestamps.csv";
+			tsFile = nowide::fopen(tsPath.c_str(), "w");
+			if (tsFile == nullptr)
+				WARN_LOG(AUDIO, "Can't create audio timestamp file %s", tsPath.c_str());
+			else
+				std::fprintf(tsFile, "sample,frame,host_time_us\n");
+		}
+		// One second of audio
+		ringBuffer.setCapacity(44100 * 4);
+		tsBuffer.setCapacity(128 * sizeof(Timestamp));
+		last_time = the_clock::time_point();
+		running = true;
+		writerThread = std::thread(&FileAudioBackend::writerMain, this);
+		INFO_LOG(AUDIO, "Writing audio to %s", path.c_str());
+
+		return true;
+	}
+
+	u32 push(const void* frame, u32 samples, bool wait) override
+	{
+		if (tsFile != nullptr)
+		{
+			Timestamp ts { sampleCount, MainFrameCount, (u64)(os_GetSeconds() * 1000000.0) };
+			if (!tsBuffer.write((const u8 *)&ts, sizeof(ts)) && lostTimestamps++ == 0)
+				WARN_LOG(AUDIO, "Audio timestamp buffer full: timestamps will be missing");
+		}
+		// Never drop samples: wait for the writer thread if the disk can't keep up
+		while (!ringBuffer.write((const u8 *)frame, samples * 4))
+		{
+			dataAvailable.Set();
+			spaceAvailable.Wait(10);
+		}
+		sampleCount += samples;
+		dataAvailable.Set();
+
+		if (wait && realtime)
+		{
+			if (last_time.time_since_epoch() != the_clock::duration::zero())
+			{
+				auto fduration = std::chrono::nanoseconds(1000000000L * samples / 44100);
+				auto duration = fduration - (the_clock::now() - last_time);
+				std::this_thread::sleep_for(duration);
+				last_time += fduration;
+			}
+			else
+				last_time = the_clock::now();
+		}
+		return 1;
+	}
+
+	void term() override
+	{
+		running = false;
+		dataAvailable.Set();
+		if (writerThread.joinable())
+			writerThread.join();
+		if (file != nullptr)
+		{
+			if (wav)
+				writeWavHeader(file, dataSize);
+			std::fclose(file);
+			file = nullptr;
+		}
+		if (tsFile != nullptr)
+		{
+			std::fclose(tsFile);
+			tsFile = nullptr;
+		}
+		if (lostTimestamps > 0)
+			WARN_LOG(AUDIO, "%u audio timestamps lost", lostTimestamps);
+		INFO_LOG(AUDIO, "Audio file closed: %" PRIu64 " samples", sampleCount);
+	}
+
+	const Option *getOptions(int *count) override
+	{
+		static Option options[4];
+		options[0].name = "format";
+		options[0].caption = "File Format";
+		options[0].type = Option::list;
+		options[0].values = { "wav", "raw" };
+
+		options[1].name = "timestamps";
+		options[1].caption = "Write Timestamps";
+		options[1].type = Option::checkbox;
+
+		options[2].name = "realtime";
+		options[2].caption = "Real-time Pacing";
+		options[2].type = Option::checkbox;
+
+		// Empty for flycast-audio.wav/raw in the data folder
+		options[3].name = "path";
+		options[3].caption = "File Path";
+		options[3].type = Option::text;
+
+		*count = 4;
+		return options;
+	}
+};
+static FileAudioBackend fileBackend;
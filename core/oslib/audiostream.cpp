@@ -1,5 +1,9 @@
 #include "audiostream.h"
 #include "cfg/option.h"
+#include "stdclass.h"
+
+#include <cmath>
+#include <thread>
 
 struct SoundFrame { s16 l; s16 r; };
 
@@ -12,20 +16,139 @@ std::vector<AudioBackend *> *AudioBackend::backends;
 static bool audio_recording_started;
 static bool eight_khz;
 
+//
+// Audio stream: lock-free ring buffer between the emulator and the audio backend.
+// The backend is fed by a dedicated thread so that the emulation thread never blocks on the audio device,
+// unless audio frame sync is enabled. Clock drift is absorbed by resampling the stream
+// to keep the ring buffer fill level close to the target latency.
+//
+namespace audiostream
+{
+
+// Maximum resampling ratio deviation (0.5%) to avoid audible pitch changes
+constexpr double MAX_RATIO_DEVIATION = 0.005;
+
+static RingBuffer ringBuffer;
+static std::thread pumpThread;
+static std::atomic_bool running { false };
+static cResetEvent readEvent;
+static u32 targetFrames;
+static std::atomic<u32> underruns;
+static std::atomic<u32> overruns;
+static std::atomic<float> currentRatio { 1.f };
+
+static void pump()
+{
+	SoundFrame src[(u32)(SAMPLE_COUNT * (1 + MAX_RATIO_DEVIATION)) + 2];
+	SoundFrame out[SAMPLE_COUNT];
+	SoundFrame last {};
+	double phase = 0;
+
+	while (running)
+	{
+		const u32 fill = ringBuffer.readSize() / sizeof(SoundFrame);
+		// Consume slightly faster when above the target latency, slower when below
+		double error = ((double)fill - targetFrames) / std::max(targetFrames, SAMPLE_COUNT);
+		double ratio = 1.0 + std::min(std::max(error * MAX_RATIO_DEVIATION, -MAX_RATIO_DEVIATION), MAX_RATIO_DEVIATION);
+		currentRatio = (float)ratio;
+
+		const u32 consumed = (u32)(phase + SAMPLE_COUNT * ratio);
+		src[0] = last;
+		if (!ringBuffer.read((u8 *)&src[1], consumed * sizeof(SoundFrame)))
+		{
+			// Not enough data: output silence and let the ring buffer fill up
+			underruns++;
+			memset(out, 0, sizeof(out));
+			currentBackend->push(out, SAMPLE_COUNT, true);
+			continue;
+		}
+		readEvent.Set();
+
+		// Linear interpolation
+		double t = phase;
+		for (SoundFrame& frame : out)
+		{
+			u32 idx = std::min((u32)t, consumed);
+			u32 next = std::min(idx + 1, consumed);
+			float frac = (float)(t - idx);
+			frame.l = (s16)std::lround(src[idx].l + (src[next].l - src[idx].l) * frac);
+			frame.r = (s16)std::lround(src[idx].r + (src[next].r - src[idx].r) * frac);
+			t += ratio;
+		}
+		phase = phase + SAMPLE_COUNT * ratio - consumed;
+		last = src[consumed];
+
+		currentBackend->push(out, SAMPLE_COUNT, true);
+	}
+}
+
+static void push(const SoundFrame *frames, u32 count)
+{
+	const u32 size = count * sizeof(SoundFrame);
+	if (config::LimitFPS)
+	{
+		// Pace the emulator on the target latency
+		while (running && ringBuffer.readSize() + size > (targetFrames + SAMPLE_COUNT) * sizeof(SoundFrame))
+			readEvent.Wait(20);
+	}
+	if (!ringBuffer.write((const u8 *)frames, size))
+		overruns++;
+}
+
+static void start()
+{
+	targetFrames = std::max<u32>(config::AudioRingLatency, SAMPLE_COUNT);
+	// Room for the target latency plus one push worth of frames on each side
+	ringBuffer.setCapacity((targetFrames * 2 + SAMPLE_COUNT * 2) * sizeof(SoundFrame));
+	underruns = 0;
+	overruns = 0;
+	currentRatio = 1.f;
+	running = true;
+	pumpThread = std::thread(pump);
+	INFO_LOG(AUDIO, "Audio stream started: target latency %d ms", targetFrames * 1000 / 44100);
+}
+
+static void stop()
+{
+	if (!running)
+		return;
+	running = false;
+	readEvent.Set();
+	pumpThread.join();
+	INFO_LOG(AUDIO, "Audio stream stopped: %d underruns, %d overruns", (u32)underruns, (u32)overruns);
+}
+
+}
+
+AudioStreamStats GetAudioStreamStats()
+{
+	AudioStreamStats stats {};
+	stats.active = audiostream::running;
+	if (stats.active)
+	{
+		stats.fill = audiostream::ringBuffer.readSize() / sizeof(SoundFrame);
+		stats.target = audiostream::targetFrames;
+		stats.underruns = audiostream::underruns;
+		stats.overruns = audiostream::overruns;
+		stats.ratio = audiostream::currentRatio;
+	}
+	return stats;
+}
+
 AudioBackend *AudioBackend::getBackend(const std::string& slug)
 {
 	if (backends == nullptr)
 		return nullptr;
 	if (slug == "auto")
 	{
-		// Prefer sdl2 if available and avoid the null driver
+		// Prefer sdl2 if available and avoid the null and file drivers
 		AudioBackend *sdlBackend = nullptr;
 		AudioBackend *autoBackend = nullptr;
 		for (auto backend : *backends)
 		{
 			if (backend->slug == "sdl2")
 				sdlBackend = backend;
-			if (backend->slug != "null" && autoBackend == nullptr)
+			if (backend->slug != "null" && backend->slug != "file" && autoBackend == nullptr)
 				autoBackend = backend;
 		}
 		if (sdlBackend != nullptr)
@@ -52,7 +175,9 @@ void WriteSample(s16 r, s16 l)
 
 	if (++writePtr == SAMPLE_COUNT)
 	{
-		if (currentBackend != nullptr)
+		if (audiostream::running)
+			audiostream::push(Buffer, SAMPLE_COUNT);
+		else if (currentBackend != nullptr)
 			currentBackend->push(Buffer, SAMPLE_COUNT, config::LimitFPS);
 		writePtr = 0;
 	}
@@ -92,6 +217,9 @@ void InitAudio()
 		return;
 	}
 
+	if (config::AudioRingBuffer)
+		audiostream::start();
+
 	if (audio_recording_started)
 	{
 		// Restart recording
@@ -109,6 +237,7 @@ void TermAudio()
 	bool rec_started = audio_recording_started;
 	StopAudioRecording();
 	audio_recording_started = rec_started;
+	audiostream::stop();
 	currentBackend->term();
 	INFO_LOG(AUDIO, "Terminating audio backend \"%s\" (%s)...", currentBackend->slug.c_str(), currentBackend->name.c_str());
 	currentBackend = nullptr;
@@ -18,7 +18,7 @@ public:
 	struct Option {
 		std::string name;
 		std::string caption;
-		enum { integer, checkbox, list } type;
+		enum { integer, checkbox, list, text } type;
 
 		int minValue;
 		int maxValue;
@@ -62,6 +62,18 @@ void InitAudio();
 void TermAudio();
 void WriteSample(s16 right, s16 left);
 
+// Fill level and drift correction of the audio stream ring buffer
+struct AudioStreamStats
+{
+	bool active;
+	u32 fill;		// buffered frames
+	u32 target;		// target latency in frames
+	u32 underruns;
+	u32 overruns;
+	float ratio;	// current resampling ratio
+};
+AudioStreamStats GetAudioStreamStats();
+
 void StartAudioRecording(bool eight_khz);
 u32 RecordAudio(void *buffer, u32 samples);
 void StopAudioRecording();
@@ -74,6 +86,7 @@ class RingBuffer
 	std::atomic_int readCursor { 0 };
 	std::atomic_int writeCursor { 0 };
 
+public:
 	u32 readSize() {
 		return (u32)((writeCursor - readCursor + buffer.size()) % buffer.size());
 	}
@@ -81,7 +94,6 @@ class RingBuffer
 		return (u32)((readCursor - writeCursor + buffer.size() - 1) % buffer.size());
 	}
 
-public:
 	bool write(const u8 *data, u32 size)
 	{
 		if (size > writeSize())
@@ -192,6 +192,11 @@ std::string getTextureDumpPath()
 	return get_writable_data_path("texdump/");
 }
 
+std::string getTextureCachePath()
+{
+	return get_writable_data_path("texcache/");
+}
+
 std::string getBiosFontPath()
 {
 	return get_readonly_data_path("font.bin");
@@ -44,6 +44,7 @@ namespace hostfs
 
 	std::string getTextureLoadPath(const std::string& gameId);
 	std::string getTextureDumpPath();
+	std::string getTextureCachePath();
 
 	std::string getShaderCachePath(const std::string& filename);
 
@@ -0,0 +1,258 @@
+#include "latency.h"
+#include "cfg/option.h"
+#include "emulator.h"
+#include "hw/pvr/Renderer_if.h"
+#include "input/gamepad_device.h"
+#include "oslib/oslib.h"
+#include "stdclass.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace latency
+{
+
+bool active;
+
+namespace
+{
+
+class LatencyTestGamepad : public GamepadDevice
+{
+public:
+	LatencyTestGamepad() : GamepadDevice(0, "latency", false)
+	{
+		_name = "Latency Test";
+		_unique_id = "latency_test";
+		input_mapper = std::make_shared<IdentityInputMapping>();
+	}
+};
+
+enum State {
+	Idle,
+	WaitDma,
+	WaitTa,
+	WaitRender,
+	WaitPresent,
+	Release,
+	Done
+};
+
+struct Sample
+{
+	u64 time[StageCount];	// host time in microseconds
+	u32 frame[StageCount];	// FrameCount
+};
+
+const char * const StageNames[StageCount] = {
+	"press", "poll", "maple_dma", "ta_list", "start_render", "present"
+};
+
+std::shared_ptr<LatencyTestGamepad> gamepad;
+std::atomic<int> state;
+std::mutex pollMutex;
+std::mt19937 rng;
+u64 nextPressTime;
+Sample current;
+std::vector<Sample> samples;
+
+u64 getTimeUs() {
+	return (u64)(os_GetSeconds() * 1000000.0);
+}
+
+void scheduleNextPress(u64 now)
+{
+	// Press at a random time so that the measurements cover all the phases of the emulated frame
+	std::uniform_int_distribution<u64> dist(100000, 300000);
+	nextPressTime = now + dist(rng);
+}
+
+const char *rendererName()
+{
+	switch ((RenderType)config::RendererType)
+	{
+	case RenderType::OpenGL:
+		return "gl";
+	case RenderType::OpenGL_OIT:
+		return "gl-oit";
+	case RenderType::Vulkan:
+		return "vulkan";
+	case RenderType::Vulkan_OIT:
+		return "vulkan-oit";
+	case RenderType::DirectX9:
+		return "dx9";
+	case RenderType::DirectX11:
+		return "dx11";
+	case RenderType::DirectX11_OIT:
+		return "dx11-oit";
+	default:
+		return "unknown";
+	}
+}
+
+void report()
+{
+	const char *renderer = rendererName();
+	const char *mode = config::ThreadedRendering ? "mt" : "st";
+	NOTICE_LOG(PROFILER, "Input latency: %d samples, renderer %s, %s rendering", (int)samples.size(),
+			renderer, config::ThreadedRendering ? "threaded" : "single-threaded");
+	for (int stage = Poll; stage < StageCount; stage++)
+	{
+		std::vector<u64> values;
+		values.reserve(samples.size());
+		for (const Sample& sample : samples)
+			values.push_back(sample.time[stage] - sample.time[Press]);
+		std::sort(values.begin(), values.end());
+		auto percentile = [&values](int p) {
+			return values[std::min(values.size() - 1, values.size() * p / 100)] / 1000.f;
+		};
+		NOTICE_LOG(PROFILER, "  %-12s min %6.2f  p50 %6.2f  p95 %6.2f  max %6.2f ms", StageNames[stage],
+				values.front() / 1000.f, percentile(50), percentile(95), values.back() / 1000.f);
+	}
+
+	std::string path = get_writable_data_path("latency-" + std::string(renderer) + "-" + mode + ".csv");
+	FILE *f = nowide::fopen(path.c_str(), "w");
+	if (f == nullptr)
+	{
+		WARN_LOG(PROFILER, "Can't create latency report %s", path.c_str());
+		return;
+	}
+	std::fprintf(f, "sample");
+	for (int stage = Poll; stage < StageCount; stage++)
+		std::fprintf(f, ",%s_us", StageNames[stage]);
+	for (int stage = Poll; stage < StageCount; stage++)
+		std::fprintf(f, ",%s_frame", StageNames[stage]);
+	std::fprintf(f, "\n");
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		const Sample& sample = samples[i];
+		std::fprintf(f, "%d", (int)i);
+		for (int stage = Poll; stage < StageCount; stage++)
+			std::fprintf(f, ",%d", (int)(sample.time[stage] - sample.time[Press]));
+		for (int stage = Poll; stage < StageCount; stage++)
+			std::fprintf(f, ",%d", (int)(sample.frame[stage] - sample.frame[Press]));
+		std::fprintf(f, "\n");
+	}
+	std::fclose(f);
+	INFO_LOG(PROFILER, "Latency report written to %s", path.c_str());
+}
+
+void record(Stage stage, u64 time)
+{
+	current.time[stage] = time;
+	current.frame[stage] = FrameCount;
+}
+
+}
+
+void init()
+{
+	if (active || config::LatencyTest <= 0)
+		return;
+	gamepad = std::make_shared<LatencyTestGamepad>();
+	GamepadDevice::Register(gamepad);
+	samples.clear();
+	samples.reserve(config::LatencyTest);
+	rng.seed(std::random_device()());
+	scheduleNextPress(getTimeUs());
+	state = Idle;
+	active = true;
+	NOTICE_LOG(PROFILER, "Input latency test started: %d samples", (int)config::LatencyTest);
+}
+
+void term()
+{
+	if (!active)
+		return;
+	active = false;
+	GamepadDevice::Unregister(gamepad);
+	gamepad.reset();
+}
+
+void poll()
+{
+	if (!active)
+		return;
+	std::lock_guard<std::mutex> _(pollMutex);
+	u64 now = getTimeUs();
+	switch (state)
+	{
+	case Idle:
+		if (now < nextPressTime)
+			break;
+		current.time[Press] = nextPressTime;
+		current.frame[Press] = FrameCount;
+		gamepad->gamepad_btn_input(DC_BTN_A, true);
+		record(Poll, now);
+		state = WaitDma;
+		break;
+	case Release:
+		gamepad->gamepad_btn_input(DC_BTN_A, false);
+		scheduleNextPress(now);
+		state = Idle;
+		break;
+	default:
+		break;
+	}
+}
+
+void update()
+{
+	if (!active)
+		return;
+	poll();
+	if (state == Done)
+	{
+		report();
+		term();
+		dc_exit();
+	}
+}
+
+void traceMapleDma(u32 kcode)
+{
+	// kcode bits are active low
+	if (state == WaitDma && (kcode & DC_BTN_A) == 0)
+	{
+		record(MapleDma, getTimeUs());
+		state = WaitTa;
+	}
+}
+
+void trace(Stage stage)
+{
+	switch (stage)
+	{
+	case TaList:
+		if (state == WaitTa)
+		{
+			record(TaList, getTimeUs());
+			state = WaitRender;
+		}
+		break;
+	case StartRender:
+		if (state == WaitRender)
+		{
+			record(StartRender, getTimeUs());
+			state = WaitPresent;
+		}
+		break;
+	case Present:
+		// The frame being presented must be the one started above or a later one
+		if (state == WaitPresent && (int)(FrameCount - current.frame[StartRender]) > 0)
+		{
+			record(Present, getTimeUs());
+			samples.push_back(current);
+			state = (int)samples.size() >= config::LatencyTest ? Done : Release;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+}
@@ -0,0 +1,51 @@
+// Input-to-photon latency measurement.
+// When Debug.LatencyTest is set to a number of samples, a virtual controller on port 1
+// presses the A button at random times. Each press is followed through the emulator
+// until the first frame rendered after the game has read it is presented.
+// Results are logged and written to latency-<renderer>-<mt|st>.csv, then the emulator exits.
+#pragma once
+#include "types.h"
+
+namespace latency
+{
+
+enum Stage {
+	Press,			// button pressed on the virtual controller
+	Poll,			// host input polled
+	MapleDma,		// controller state read by the game
+	TaList,			// first TA list started after the controller read
+	StartRender,	// first frame render started after the controller read
+	Present,		// frame presented
+	StageCount
+};
+
+extern bool active;
+
+void init();
+void term();
+// Poll the virtual controller. Must be called wherever the host input is polled.
+void poll();
+// Called by the UI thread after polling the host input. Reports the results when done.
+void update();
+
+void trace(Stage stage);
+void traceMapleDma(u32 kcode);
+
+static inline void mapleDma(u32 kcode) {
+	if (active)
+		traceMapleDma(kcode);
+}
+static inline void taListInit() {
+	if (active)
+		trace(TaList);
+}
+static inline void startRender() {
+	if (active)
+		trace(StartRender);
+}
+static inline void present() {
+	if (active)
+		trace(Present);
+}
+
+}
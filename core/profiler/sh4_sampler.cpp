@@ -0,0 +1,287 @@
+#include "sh4_sampler.h"
+#include "cfg/option.h"
+#include "emulator.h"
+#include "hw/sh4/sh4_if.h"
+#include "hw/sh4/dyna/blockmanager.h"
+#include "oslib/host_context.h"
+#include "stdclass.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(TARGET_NO_EXCEPTIONS) && (defined(__unix__) || defined(__APPLE__)) && !defined(__SWITCH__)
+#include <csignal>
+#include <cerrno>
+#include <pthread.h>
+#define USE_SIGNALS
+
+void context_from_segfault(host_context_t* hctx, void* segfault_ctx);
+#endif
+
+namespace sampler
+{
+
+namespace
+{
+
+struct Sample
+{
+	unat hostPc;
+	u32 pc;
+	u32 pr;
+};
+
+// Single producer (signal handler or sampler thread), single consumer (SH4 thread)
+constexpr u32 RingSize = 4096;
+Sample ring[RingSize];
+std::atomic<u32> ringHead;
+std::atomic<u32> ringTail;
+std::atomic<u32> lostSamples;
+
+enum Origin {
+	Guest,		// dynarec block or interpreter
+	Emulator	// host code called by the dynarec
+};
+
+struct StackKey
+{
+	Origin origin;
+	u32 caller;
+	u32 addr;
+
+	bool operator<(const StackKey& other) const {
+		if (origin != other.origin)
+			return origin < other.origin;
+		if (addr != other.addr)
+			return addr < other.addr;
+		return caller < other.caller;
+	}
+};
+std::map<StackKey, u32> stacks;
+u64 totalSamples;
+
+std::thread samplerThread;
+std::mutex mutex;
+std::condition_variable stopRequested;
+bool running;
+
+#if defined(USE_SIGNALS)
+pthread_t sh4Thread;
+bool handlerInstalled;
+struct sigaction prevHandler;
+#elif defined(_WIN32)
+HANDLE sh4Thread;
+#endif
+
+void push(unat hostPc)
+{
+	const u32 head = ringHead.load(std::memory_order_relaxed);
+	if (head - ringTail.load(std::memory_order_acquire) >= RingSize)
+	{
+		lostSamples++;
+		return;
+	}
+	Sample& sample = ring[head % RingSize];
+	sample.hostPc = hostPc;
+	sample.pc = Sh4cntx.pc;
+	sample.pr = Sh4cntx.pr;
+	ringHead.store(head + 1, std::memory_order_release);
+}
+
+#ifdef USE_SIGNALS
+void signalHandler(int sig, siginfo_t *si, void *context)
+{
+	const int savedErrno = errno;
+#if HOST_CPU != CPU_GENERIC
+	host_context_t ctx;
+	context_from_segfault(&ctx, context);
+	push(ctx.pc);
+#else
+	push(0);
+#endif
+	errno = savedErrno;
+}
+#endif
+
+// Interrupt the SH4 thread and record where it is
+void sample()
+{
+#if defined(USE_SIGNALS)
+	pthread_kill(sh4Thread, SIGPROF);
+#elif defined(_WIN32)
+	if (SuspendThread(sh4Thread) == (DWORD)-1)
+		return;
+	CONTEXT ctx{};
+	ctx.ContextFlags = CONTEXT_CONTROL;
+	if (GetThreadContext(sh4Thread, &ctx))
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		push((unat)ctx.Rip);
+#elif defined(_M_IX86) || defined(__i386__)
+		push((unat)ctx.Eip);
+#elif defined(_M_ARM64) || defined(__aarch64__)
+		push((unat)ctx.Pc);
+#else
+		push(0);
+#endif
+	}
+	ResumeThread(sh4Thread);
+#else
+	// No way to get the host pc
+	push(0);
+#endif
+}
+
+void samplerLoop()
+{
+	const auto period = std::chrono::microseconds(1000000 / std::max<int>(config::SH4Profiler, 1));
+	auto nextSample = std::chrono::steady_clock::now() + period;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (running)
+	{
+		if (stopRequested.wait_until(lock, nextSample, [] { return !running; }))
+			break;
+		sample();
+		nextSample += period;
+	}
+}
+
+// Attribute the pending samples. Runs on the SH4 thread so that the block manager can be used.
+void processSamples()
+{
+	u32 tail = ringTail.load(std::memory_order_relaxed);
+	const u32 head = ringHead.load(std::memory_order_acquire);
+	for (; tail != head; tail++)
+	{
+		const Sample& sample = ring[tail % RingSize];
+		StackKey key{ Guest, sample.pr, sample.pc };
+#if FEAT_SHREC != DYNAREC_NONE
+		if (config::DynarecEnabled && sample.hostPc != 0)
+		{
+			RuntimeBlockInfoPtr block = bm_GetBlock((void *)sample.hostPc);
+			if (block)
+				key.addr = block->vaddr;
+			else
+				// Memory handlers, scheduler, ... The guest pc is only indicative.
+				key = { Emulator, 0, sample.pc };
+		}
+#endif
+		stacks[key]++;
+		totalSamples++;
+	}
+	ringTail.store(tail, std::memory_order_release);
+}
+
+void vblankCallback(Event event, void *)
+{
+	processSamples();
+}
+
+void report()
+{
+	if (lostSamples > 0)
+		WARN_LOG(PROFILER, "SH4 profiler: %d samples lost", (int)lostSamples);
+	// Top blocks by number of samples
+	std::map<u32, u32> blocks;
+	for (const auto& it : stacks)
+		if (it.first.origin == Guest)
+			blocks[it.first.addr] += it.second;
+	std::vector<std::pair<u32, u32>> topBlocks(blocks.begin(), blocks.end());
+	std::sort(topBlocks.begin(), topBlocks.end(), [](const std::pair<u32, u32>& a, const std::pair<u32, u32>& b) {
+		return a.second > b.second;
+	});
+	NOTICE_LOG(PROFILER, "SH4 profile: %d samples", (int)totalSamples);
+	for (size_t i = 0; i < topBlocks.size() && i < 20; i++)
+		NOTICE_LOG(PROFILER, "  %08x %6.2f%%", topBlocks[i].first, topBlocks[i].second * 100.f / totalSamples);
+
+	std::string path = get_writable_data_path("sh4-profile.folded");
+	FILE *f = nowide::fopen(path.c_str(), "w");
+	if (f == nullptr)
+	{
+		WARN_LOG(PROFILER, "Can't create SH4 profile %s", path.c_str());
+		return;
+	}
+	for (const auto& it : stacks)
+	{
+		if (it.first.origin == Guest)
+			std::fprintf(f, "sh4;%08x;%08x %u\n", it.first.caller, it.first.addr, it.second);
+		else
+			std::fprintf(f, "emulator;%08x %u\n", it.first.addr, it.second);
+	}
+	std::fclose(f);
+	INFO_LOG(PROFILER, "SH4 profile written to %s", path.c_str());
+}
+
+}
+
+void start()
+{
+	if (config::SH4Profiler <= 0 || running)
+		return;
+#if defined(USE_SIGNALS)
+	if (!handlerInstalled)
+	{
+		struct sigaction act{};
+		act.sa_sigaction = signalHandler;
+		sigemptyset(&act.sa_mask);
+		act.sa_flags = SA_SIGINFO | SA_RESTART;
+		sigaction(SIGPROF, &act, &prevHandler);
+		handlerInstalled = true;
+	}
+	sh4Thread = pthread_self();
+#elif defined(_WIN32)
+	sh4Thread = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT, FALSE, GetCurrentThreadId());
+	if (sh4Thread == nullptr)
+	{
+		WARN_LOG(PROFILER, "SH4 profiler: OpenThread failed");
+		return;
+	}
+#endif
+	EventManager::listen(Event::VBlank, vblankCallback);
+	running = true;
+	samplerThread = std::thread(samplerLoop);
+}
+
+void stop()
+{
+	if (!running)
+		return;
+	{
+		std::lock_guard<std::mutex> _(mutex);
+		running = false;
+	}
+	stopRequested.notify_one();
+	samplerThread.join();
+	EventManager::unlisten(Event::VBlank, vblankCallback);
+#ifdef _WIN32
+	CloseHandle(sh4Thread);
+	sh4Thread = nullptr;
+#endif
+	processSamples();
+}
+
+void term()
+{
+	stop();
+	if (totalSamples > 0)
+		report();
+	stacks.clear();
+	totalSamples = 0;
+	lostSamples = 0;
+#ifdef USE_SIGNALS
+	if (handlerInstalled)
+	{
+		sigaction(SIGPROF, &prevHandler, nullptr);
+		handlerInstalled = false;
+	}
+#endif
+}
+
+}
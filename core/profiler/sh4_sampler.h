@@ -0,0 +1,21 @@
+// Sampling profiler for guest SH4 code.
+// When Debug.SH4Profiler is set to a sampling frequency in Hz, the thread running the SH4 is
+// interrupted periodically to record the host pc and the guest pc and pr registers.
+// Samples whose host pc is in a dynarec block are attributed to the block, with pr as the caller.
+// Other samples are attributed to the emulator, or to the guest pc when using the interpreter.
+// The profile is written to sh4-profile.folded when the game is unloaded. This is the folded stack
+// format used by flamegraph.pl and speedscope.
+#pragma once
+#include "types.h"
+
+namespace sampler
+{
+
+// Start sampling the calling thread, which must be the one running the SH4
+void start();
+// Stop sampling
+void stop();
+// Write the profile and discard the samples
+void term();
+
+}
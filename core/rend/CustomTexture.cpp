@@ -21,8 +21,12 @@
 #include "oslib/directory.h"
 #include "cfg/option.h"
 #include "oslib/oslib.h"
+#include "deps/xbrz/xbrz.h"
 
 #include <sstream>
+#include <ctime>
+#include <xxhash.h>
+#include <zlib.h>
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_ONLY_JPEG
 #define STBI_ONLY_PNG
@@ -32,53 +36,241 @@
 
 CustomTexture custom_texture;
 
-void CustomTexture::LoaderThread()
+void CustomTexture::LoaderThread(bool loadMap)
 {
-	LoadMap();
-	while (initialized)
+	if (loadMap)
 	{
-		BaseTextureCacheData *texture;
-		
-		do {
-			texture = nullptr;
-			{
-				std::unique_lock<std::mutex> lock(work_queue_mutex);
-				if (!work_queue.empty())
-				{
-					texture = work_queue.back();
-					work_queue.pop_back();
-				}
-			}
-			
-			if (texture != nullptr)
+		LoadMap();
+		std::lock_guard<std::mutex> lock(work_queue_mutex);
+		map_loaded = true;
+		work_available.notify_all();
+	}
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(work_queue_mutex);
+			work_available.wait(lock, [this]() { return !initialized || (map_loaded && !work_queue.empty()); });
+			if (!initialized)
+				break;
+			// A texture can be queued more than once. Don't process it concurrently
+			auto it = work_queue.rbegin();
+			for (; it != work_queue.rend(); ++it)
+				if (work_in_progress.count(it->texture) == 0)
+					break;
+			if (it == work_queue.rend())
 			{
-				texture->ComputeHash();
-				if (texture->custom_image_data != nullptr)
-				{
-					free(texture->custom_image_data);
-					texture->custom_image_data = nullptr;
-				}
-				if (!texture->dirty)
-				{
-					int width, height;
-					u8 *image_data = LoadCustomTexture(texture->texture_hash, width, height);
-					if (image_data == nullptr)
-					{
-						image_data = LoadCustomTexture(texture->old_texture_hash, width, height);
-					}
-					if (image_data != nullptr)
-					{
-						texture->custom_width = width;
-						texture->custom_height = height;
-						texture->custom_image_data = image_data;
-					}
-				}
-				texture->custom_load_in_progress--;
+				// Only textures being loaded by other threads are left
+				work_available.wait(lock);
+				continue;
 			}
+			job = std::move(*it);
+			work_queue.erase(std::next(it).base());
+			work_in_progress.insert(job.texture);
+		}
+		ProcessJob(job);
+		{
+			std::lock_guard<std::mutex> lock(work_queue_mutex);
+			work_in_progress.erase(job.texture);
+			job.texture->custom_load_in_progress--;
+		}
+		work_available.notify_all();
+	}
+}
 
-		} while (texture != nullptr);
-		
-		wakeup_thread.Wait();
+void CustomTexture::ProcessJob(Job& job)
+{
+	BaseTextureCacheData *texture = job.texture;
+	if (texture->custom_image_data != nullptr)
+	{
+		free(texture->custom_image_data);
+		texture->custom_image_data = nullptr;
+	}
+	int width, height;
+	u8 *image_data = nullptr;
+	if (job.customTexture && custom_textures_available)
+	{
+		texture->ComputeHash();
+		if (!texture->dirty)
+		{
+			image_data = LoadCustomTexture(texture->texture_hash, width, height);
+			if (image_data == nullptr)
+				image_data = LoadCustomTexture(texture->old_texture_hash, width, height);
+		}
+	}
+	// Custom textures have priority
+	if (image_data == nullptr && !job.pixels.empty() && !texture->dirty)
+		image_data = UpscaleTexture(job, width, height);
+	if (image_data != nullptr)
+	{
+		// Checked by the render thread in case the texture has been updated since
+		texture->custom_updates = job.updates;
+		texture->custom_width = width;
+		texture->custom_height = height;
+		texture->custom_image_data = image_data;
+	}
+}
+
+u8 *CustomTexture::UpscaleTexture(Job& job, int& width, int& height)
+{
+	const int factor = config::TextureUpscale;
+	const bool directX = BaseTextureCacheData::IsDirectXColorOrder();
+	const u64 seed = ((u64)job.width << 32) | ((u64)job.height << 16) | (factor << 2) | (job.hasAlpha << 1) | (int)directX;
+	const u64 key = XXH64(job.pixels.data(), job.pixels.size() * sizeof(u32), seed) | (1ull << 63);
+
+	u8 *data = GetCachedImage(key, width, height);
+	if (data != nullptr)
+		return data;
+
+	std::string path;
+	if (!upscale_cache_path.empty())
+	{
+		std::stringstream ss;
+		ss << upscale_cache_path << std::hex << key << ".bin";
+		path = ss.str();
+	}
+	std::vector<u8> image;
+	if (path.empty() || !LoadUpscaledTexture(path, image, width, height))
+	{
+		width = job.width * factor;
+		height = job.height * factor;
+		image.resize((size_t)width * height * 4);
+		// Already running in parallel with the other loader threads
+		static const xbrz::ScalerCfg xbrzConfig;
+		xbrz::scale(factor, job.pixels.data(), (u32 *)image.data(), job.width, job.height,
+				job.hasAlpha ? xbrz::ColorFormat::ARGB : xbrz::ColorFormat::RGB, xbrzConfig);
+		if (directX)
+			// Textures are handed over in RGBA order like custom textures
+			for (size_t i = 0; i < image.size(); i += 4)
+				std::swap(image[i], image[i + 2]);
+		if (!path.empty())
+			SaveUpscaledTexture(path, image.data(), width, height);
+	}
+	CacheImage(key, image.data(), width, height);
+
+	data = (u8 *)malloc(image.size());
+	if (data != nullptr)
+		memcpy(data, image.data(), image.size());
+	return data;
+}
+
+namespace {
+
+struct UpscaledTextureHeader
+{
+	static constexpr u32 Magic = 0x58455455;	// UTEX
+	u32 magic;
+	u32 width;
+	u32 height;
+};
+
+}
+
+bool CustomTexture::LoadUpscaledTexture(const std::string& path, std::vector<u8>& data, int& width, int& height)
+{
+	FILE *file = nowide::fopen(path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+	UpscaledTextureHeader header;
+	bool success = false;
+	long size = 0;
+	if (std::fread(&header, sizeof(header), 1, file) == 1 && header.magic == UpscaledTextureHeader::Magic
+			&& header.width <= 8192 && header.height <= 8192)
+	{
+		std::fseek(file, 0, SEEK_END);
+		size = std::ftell(file) - (long)sizeof(header);
+		std::fseek(file, sizeof(header), SEEK_SET);
+		std::vector<u8> compressed(std::max(size, 0l));
+		if (size > 0 && std::fread(compressed.data(), 1, size, file) == (size_t)size)
+		{
+			data.resize((size_t)header.width * header.height * 4);
+			uLongf length = data.size();
+			success = uncompress(data.data(), &length, compressed.data(), compressed.size()) == Z_OK
+					&& length == data.size();
+		}
+	}
+	std::fclose(file);
+	if (!success)
+	{
+		WARN_LOG(RENDERER, "Invalid upscaled texture %s", path.c_str());
+		return false;
+	}
+	UseDiskCacheFile(path, sizeof(header) + size);
+	width = header.width;
+	height = header.height;
+	return true;
+}
+
+void CustomTexture::SaveUpscaledTexture(const std::string& path, const u8 *data, int width, int height)
+{
+	if (!file_exists(upscale_cache_path))
+	{
+		std::string base_dir = hostfs::getTextureCachePath();
+		if (!file_exists(base_dir))
+			make_directory(base_dir);
+		make_directory(upscale_cache_path);
+	}
+	const uLong size = (uLong)width * height * 4;
+	std::vector<u8> compressed(compressBound(size));
+	uLongf length = compressed.size();
+	if (compress2(compressed.data(), &length, data, size, Z_BEST_SPEED) != Z_OK)
+		return;
+
+	FILE *file = nowide::fopen(path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		WARN_LOG(RENDERER, "Can't save upscaled texture %s", path.c_str());
+		return;
+	}
+	UpscaledTextureHeader header{ UpscaledTextureHeader::Magic, (u32)width, (u32)height };
+	std::fwrite(&header, sizeof(header), 1, file);
+	std::fwrite(compressed.data(), 1, length, file);
+	std::fclose(file);
+	UseDiskCacheFile(path, sizeof(header) + length);
+}
+
+// Must be called with disk_cache_mutex held
+void CustomTexture::ScanDiskCache()
+{
+	disk_cache_scanned = true;
+	DIR *dir = flycast::opendir(upscale_cache_path.c_str());
+	if (dir == nullptr)
+		return;
+	while (dirent *entry = flycast::readdir(dir))
+	{
+		std::string name = entry->d_name;
+		if (get_file_extension(name) != "bin")
+			continue;
+		std::string path = upscale_cache_path + name;
+		struct stat st;
+		if (flycast::stat(path.c_str(), &st) != 0)
+			continue;
+		// Files that haven't been used in this session are evicted in the order they were written
+		disk_cache[path] = { (size_t)st.st_size, (u64)st.st_mtime };
+		disk_cache_size += st.st_size;
+	}
+	flycast::closedir(dir);
+}
+
+void CustomTexture::UseDiskCacheFile(const std::string& path, size_t size)
+{
+	std::lock_guard<std::mutex> lock(disk_cache_mutex);
+	if (!disk_cache_scanned)
+		ScanDiskCache();
+	DiskCacheFile& file = disk_cache[path];
+	disk_cache_size += size - file.size;
+	file.size = size;
+	file.lastUse = (u64)time(nullptr);
+	// Delete the least recently used files
+	while (disk_cache_size > MaxDiskCacheSize && disk_cache.size() > 1)
+	{
+		auto lru = disk_cache.begin();
+		for (auto it = disk_cache.begin(); it != disk_cache.end(); ++it)
+			if (it->second.lastUse < lru->second.lastUse)
+				lru = it;
+		nowide::remove(lru->first.c_str());
+		disk_cache_size -= lru->second.size;
+		disk_cache.erase(lru);
 	}
 }
 
@@ -99,9 +291,13 @@ bool CustomTexture::Init()
 	if (!initialized)
 	{
 		initialized = true;
+		custom_textures_available = false;
+		map_loaded = true;
+		upscale_cache_path.clear();
 		std::string game_id = GetGameId();
 		if (game_id.length() > 0)
 		{
+			upscale_cache_path = hostfs::getTextureCachePath() + game_id + "/";
 			textures_path = hostfs::getTextureLoadPath(game_id);
 
 			if (!textures_path.empty())
@@ -112,10 +308,14 @@ bool CustomTexture::Init()
 					NOTICE_LOG(RENDERER, "Found custom textures directory: %s", textures_path.c_str());
 					custom_textures_available = true;
 					flycast::closedir(dir);
-					loader_thread.Start();
+					map_loaded = false;
 				}
 			}
 		}
+		// Decoding and upscaling are the bottleneck so use several threads
+		unsigned threadCount = std::max(1u, std::min(std::thread::hardware_concurrency(), 4u));
+		for (unsigned i = 0; i < threadCount; i++)
+			loader_threads.emplace_back(&CustomTexture::LoaderThread, this, i == 0 && !map_loaded);
 	}
 	return custom_textures_available;
 }
@@ -124,14 +324,24 @@ void CustomTexture::Terminate()
 {
 	if (initialized)
 	{
-		initialized = false;
 		{
 			std::unique_lock<std::mutex> lock(work_queue_mutex);
+			initialized = false;
+			for (Job& job : work_queue)
+				job.texture->custom_load_in_progress--;
 			work_queue.clear();
 		}
-		wakeup_thread.Set();
-		loader_thread.WaitToEnd();
+		work_available.notify_all();
+		for (std::thread& thread : loader_threads)
+			thread.join();
+		loader_threads.clear();
+		work_in_progress.clear();
 		texture_map.clear();
+		image_cache.clear();
+		image_cache_size = 0;
+		disk_cache.clear();
+		disk_cache_size = 0;
+		disk_cache_scanned = false;
 	}
 }
 
@@ -141,27 +351,101 @@ u8* CustomTexture::LoadCustomTexture(u32 hash, int& width, int& height)
 	if (it == texture_map.end())
 		return nullptr;
 
+	u8 *imgData = GetCachedImage(hash, width, height);
+	if (imgData != nullptr)
+		return imgData;
+
 	FILE *file = nowide::fopen(it->second.c_str(), "rb");
 	if (file == nullptr)
 		return nullptr;
 	int n;
-	stbi_set_flip_vertically_on_load(1);
-	u8 *imgData = stbi_load_from_file(file, &width, &height, &n, STBI_rgb_alpha);
+	stbi_set_flip_vertically_on_load_thread(1);
+	imgData = stbi_load_from_file(file, &width, &height, &n, STBI_rgb_alpha);
 	std::fclose(file);
+	if (imgData != nullptr)
+		CacheImage(hash, imgData, width, height);
 	return imgData;
 }
 
+// Returns a copy of the cached image since the caller takes ownership of it
+u8 *CustomTexture::GetCachedImage(u64 key, int& width, int& height)
+{
+	std::lock_guard<std::mutex> lock(image_cache_mutex);
+	auto it = image_cache.find(key);
+	if (it == image_cache.end())
+		return nullptr;
+	DecodedImage& image = it->second;
+	u8 *data = (u8 *)malloc(image.data.size());
+	if (data == nullptr)
+		return nullptr;
+	memcpy(data, image.data.data(), image.data.size());
+	width = image.width;
+	height = image.height;
+	image.lastUse = ++image_cache_clock;
+	return data;
+}
+
+void CustomTexture::CacheImage(u64 key, const u8 *data, int width, int height)
+{
+	size_t size = (size_t)width * height * 4;
+	if (size > MaxCacheSize / 4)
+		return;
+	std::lock_guard<std::mutex> lock(image_cache_mutex);
+	if (image_cache.count(key) != 0)
+		return;
+	// Evict the least recently used images
+	while (image_cache_size + size > MaxCacheSize && !image_cache.empty())
+	{
+		auto lru = image_cache.begin();
+		for (auto it = image_cache.begin(); it != image_cache.end(); ++it)
+			if (it->second.lastUse < lru->second.lastUse)
+				lru = it;
+		image_cache_size -= lru->second.data.size();
+		image_cache.erase(lru);
+	}
+	DecodedImage& image = image_cache[key];
+	image.data.assign(data, data + size);
+	image.width = width;
+	image.height = height;
+	image.lastUse = ++image_cache_clock;
+	image_cache_size += size;
+}
+
 void CustomTexture::LoadCustomTextureAsync(BaseTextureCacheData *texture_data)
 {
 	if (!Init())
 		return;
 
-	texture_data->custom_load_in_progress++;
+	Job job{};
+	job.texture = texture_data;
+	job.customTexture = true;
+	job.updates = texture_data->Updates;
+	QueueJob(std::move(job));
+}
+
+void CustomTexture::UpscaleTextureAsync(BaseTextureCacheData *texture_data, const u32 *pixels, int width, int height, bool has_alpha)
+{
+	Init();
+
+	Job job;
+	job.texture = texture_data;
+	job.customTexture = config::CustomTextures;
+	job.pixels.assign(pixels, pixels + width * height);
+	job.width = width;
+	job.height = height;
+	job.hasAlpha = has_alpha;
+	job.updates = texture_data->Updates;
+	QueueJob(std::move(job));
+}
+
+void CustomTexture::QueueJob(Job&& job)
+{
+	job.texture->custom_load_in_progress++;
 	{
 		std::unique_lock<std::mutex> lock(work_queue_mutex);
-		work_queue.insert(work_queue.begin(), texture_data);
+		work_queue.insert(work_queue.begin(), std::move(job));
 	}
-	wakeup_thread.Set();
+	work_available.notify_one();
 }
 
 void CustomTexture::DumpTexture(u32 hash, int w, int h, TextureType textype, void *src_buffer)
@@ -21,36 +21,88 @@
 #include "TexCache.h"
 #include "stdclass.h"
 
+#include <condition_variable>
 #include <string>
+#include <thread>
 #include <vector>
 #include <map>
 #include <mutex>
+#include <set>
 
 class CustomTexture {
 public:
-	CustomTexture() : loader_thread(loader_thread_func, this) {}
 	~CustomTexture() { Terminate(); }
 	u8* LoadCustomTexture(u32 hash, int& width, int& height);
 	void LoadCustomTextureAsync(BaseTextureCacheData *texture_data);
+	// Upscale the texture in the background. The result replaces the texture like a custom texture.
+	void UpscaleTextureAsync(BaseTextureCacheData *texture_data, const u32 *pixels, int width, int height, bool has_alpha);
 	void DumpTexture(u32 hash, int w, int h, TextureType textype, void *src_buffer);
 	void Terminate();
 
 private:
 	bool Init();
-	void LoaderThread();
+	void LoaderThread(bool loadMap);
 	std::string GetGameId();
 	void LoadMap();
-	
-	static void *loader_thread_func(void *param) { ((CustomTexture *)param)->LoaderThread(); return NULL; }
+	u8 *GetCachedImage(u64 key, int& width, int& height);
+	void CacheImage(u64 key, const u8 *data, int width, int height);
+
+	struct Job
+	{
+		BaseTextureCacheData *texture;
+		bool customTexture;
+		// Texture to upscale, if any
+		std::vector<u32> pixels;
+		int width;
+		int height;
+		bool hasAlpha;
+		u32 updates;
+	};
+	void QueueJob(Job&& job);
+	void ProcessJob(Job& job);
+	u8 *UpscaleTexture(Job& job, int& width, int& height);
+	bool LoadUpscaledTexture(const std::string& path, std::vector<u8>& data, int& width, int& height);
+	void SaveUpscaledTexture(const std::string& path, const u8 *data, int width, int height);
+	void ScanDiskCache();
+	void UseDiskCacheFile(const std::string& path, size_t size);
+
+	// Decoded images are kept to avoid decoding them again when textures are re-created
+	struct DecodedImage
+	{
+		std::vector<u8> data;
+		int width;
+		int height;
+		u64 lastUse;
+	};
+	static constexpr size_t MaxCacheSize = 256 * 1024 * 1024;
+	// Upscaled textures saved on disk, per game
+	struct DiskCacheFile
+	{
+		size_t size;
+		u64 lastUse;
+	};
+	static constexpr size_t MaxDiskCacheSize = 512 * 1024 * 1024;
 	
 	bool initialized = false;
 	bool custom_textures_available = false;
+	bool map_loaded = false;
 	std::string textures_path;
-	cThread loader_thread;
-	cResetEvent wakeup_thread;
-	std::vector<BaseTextureCacheData *> work_queue;
+	std::vector<std::thread> loader_threads;
+	std::condition_variable work_available;
+	std::vector<Job> work_queue;
+	std::set<BaseTextureCacheData *> work_in_progress;
 	std::mutex work_queue_mutex;
 	std::map<u32, std::string> texture_map;
+	std::string upscale_cache_path;
+	// Custom textures are keyed by their 32-bit hash. Upscaled textures by a 64-bit hash with the top bit set.
+	std::map<u64, DecodedImage> image_cache;
+	size_t image_cache_size = 0;
+	u64 image_cache_clock = 0;
+	std::mutex image_cache_mutex;
+	std::map<std::string, DiskCacheFile> disk_cache;
+	size_t disk_cache_size = 0;
+	bool disk_cache_scanned = false;
+	std::mutex disk_cache_mutex;
 };
 
 extern CustomTexture custom_texture;
@@ -226,9 +226,11 @@ bool VramLockedWriteOffset(size_t offset)
 		{
 			if (lock != nullptr)
 			{
-				lock->texture->invalidate();
+				BaseTextureCacheData *texture = lock->texture;
+				texture->invalidate((u32)offset);
 
-				if (lock != nullptr)
+				// Textures that can be partially updated keep their lock
+				if (lock != nullptr && !texture->partialUpdate)
 				{
 					ERROR_LOG(PVR, "Error : pvr is supposed to remove lock");
 					die("Invalid state");
@@ -313,18 +315,19 @@ struct PvrTexInfo
 	TexConvFP32 VQ32;
 	// Conversion to 8 bpp (palette)
 	TexConvFP8 TW8;
+	TexConvFP8 VQ8;
 };
 
 #define TEX_CONV_TABLE \
 const PvrTexInfo pvrTexInfo[8] = \
-{	/* name     bpp Final format			   Planar		Twiddled	 VQ				Planar(32b)    Twiddled(32b)  VQ (32b)      Palette (8b)	*/	\
-	{"1555", 	16,	TextureType::_5551,        tex1555_PL,  tex1555_TW,  tex1555_VQ,    tex1555_PL32,  tex1555_TW32,  tex1555_VQ32, nullptr },			\
-	{"565", 	16, TextureType::_565,         tex565_PL,   tex565_TW,   tex565_VQ,     tex565_PL32,   tex565_TW32,   tex565_VQ32,  nullptr },	    	\
-	{"4444", 	16, TextureType::_4444,        tex4444_PL,  tex4444_TW,  tex4444_VQ,    tex4444_PL32,  tex4444_TW32,  tex4444_VQ32, nullptr },	    	\
-	{"yuv", 	16, TextureType::_8888,        nullptr,     nullptr,     nullptr,       texYUV422_PL,  texYUV422_TW,  texYUV422_VQ, nullptr },			\
-	{"bumpmap", 16, TextureType::_4444,        texBMP_PL,   texBMP_TW,	 texBMP_VQ,     tex4444_PL32,  tex4444_TW32,  tex4444_VQ32, nullptr },			\
-	{"pal4", 	4,	TextureType::_5551,		   nullptr,     texPAL4_TW,  texPAL4_VQ,    nullptr,       texPAL4_TW32,  texPAL4_VQ32, texPAL4PT_TW },		\
-	{"pal8", 	8,	TextureType::_5551,		   nullptr,     texPAL8_TW,  texPAL8_VQ,    nullptr,       texPAL8_TW32,  texPAL8_VQ32, texPAL8PT_TW },		\
+{	/* name     bpp Final format			   Planar		Twiddled	 VQ				Planar(32b)    Twiddled(32b)  VQ (32b)      Palette (8b)  Palette VQ (8b) */	\
+	{"1555", 	16,	TextureType::_5551,        tex1555_PL,  tex1555_TW,  tex1555_VQ,    tex1555_PL32,  tex1555_TW32,  tex1555_VQ32, nullptr,      nullptr },		\
+	{"565", 	16, TextureType::_565,         tex565_PL,   tex565_TW,   tex565_VQ,     tex565_PL32,   tex565_TW32,   tex565_VQ32,  nullptr,      nullptr },		\
+	{"4444", 	16, TextureType::_4444,        tex4444_PL,  tex4444_TW,  tex4444_VQ,    tex4444_PL32,  tex4444_TW32,  tex4444_VQ32, nullptr,      nullptr },		\
+	{"yuv", 	16, TextureType::_8888,        nullptr,     nullptr,     nullptr,       texYUV422_PL,  texYUV422_TW,  texYUV422_VQ, nullptr,      nullptr },		\
+	{"bumpmap", 16, TextureType::_4444,        texBMP_PL,   texBMP_TW,	 texBMP_VQ,     tex4444_PL32,  tex4444_TW32,  tex4444_VQ32, nullptr,      nullptr },		\
+	{"pal4", 	4,	TextureType::_5551,		   nullptr,     texPAL4_TW,  texPAL4_VQ,    nullptr,       texPAL4_TW32,  texPAL4_VQ32, texPAL4PT_TW, texPAL4PT_VQ },	\
+	{"pal8", 	8,	TextureType::_5551,		   nullptr,     texPAL8_TW,  texPAL8_VQ,    nullptr,       texPAL8_TW32,  texPAL8_VQ32, texPAL8PT_TW, texPAL8PT_VQ },	\
 	{"ns/1555", 0},	                                                                                                                                    \
 }
 
@@ -336,6 +339,7 @@ namespace directx {
 }
 #undef TEX_CONV_TABLE
 static const PvrTexInfo *pvrTexInfo = opengl::pvrTexInfo;
+bool BaseTextureCacheData::gpuPaletteFiltering;
 
 extern const u32 VQMipPoint[11] =
 {
@@ -473,7 +477,11 @@ BaseTextureCacheData::BaseTextureCacheData(TSP tsp, TCW tcw)
 	Updates = 0;
 	dirty = FrameCount;
 	lock_block = nullptr;
+	dirtyStart = 0;
+	dirtyEnd = 0;
+	partialUpdate = false;
 	custom_image_data = nullptr;
+	custom_updates = 0;
 	custom_load_in_progress = 0;
 	gpuPalette = false;
 
@@ -537,6 +545,7 @@ BaseTextureCacheData::BaseTextureCacheData(TSP tsp, TCW tcw)
 			texconv = tex->VQ;
 			texconv32 = tex->VQ32;
 			size = width * height / 8 + 256 * 8;
+			texconv8 = tex->VQ8;
 		}
 		else
 		{
@@ -570,11 +579,104 @@ void BaseTextureCacheData::ComputeHash()
 	texture_hash ^= tcw.full & tcwMask;
 }
 
+// Returns the position of a twiddled pixel and the dimensions of the block made of the given number of low address bits.
+// Address bits alternate between y and x, starting with y, until one dimension is exhausted.
+static void untwiddle(u32 address, u32 blockBits, u32 bcx, u32 bcy, u32& x, u32& y, u32& blockWidth, u32& blockHeight)
+{
+	x = y = 0;
+	u32 xbits = 0;
+	u32 ybits = 0;
+	for (u32 i = 0; xbits < bcx || ybits < bcy; i++)
+	{
+		if (i == blockBits)
+		{
+			blockWidth = 1 << xbits;
+			blockHeight = 1 << ybits;
+		}
+		u32 bit = (address >> i) & 1;
+		if (ybits < bcy && (ybits == xbits || xbits == bcx))
+			y |= bit << ybits++;
+		else
+			x |= bit << xbits++;
+	}
+	if (blockBits >= bcx + bcy)
+	{
+		blockWidth = 1 << bcx;
+		blockHeight = 1 << bcy;
+	}
+}
+
+// Decode and upload the part of the texture in the given vram range
+template<typename Pixel>
+static void updateDirtyRange(BaseTextureCacheData *texture, void (*texconv)(PixelBuffer<Pixel> *, const u8 *, u32, u32),
+		const PvrTexInfo *tex, u32 start, u32 end)
+{
+	start = std::max(start, texture->sa);
+	end = std::min(end, texture->sa + texture->size);
+	if (start >= end)
+		return;
+	// Converters work on 64-bit words
+	start = (start - texture->sa) & ~7;
+	end = (end - texture->sa + 7) & ~7;
+
+	PixelBuffer<Pixel> pb;
+	if (texture->tcw.ScanOrder)
+	{
+		// Planar: update whole lines
+		const u32 lineSize = texture->width * tex->bpp / 8;
+		const u32 y = start / lineSize;
+		const u32 lines = (end + lineSize - 1) / lineSize - y;
+		pb.init(texture->width, lines);
+		texconv(&pb, &vram[texture->sa + y * lineSize], texture->width, lines);
+		texture->UploadSubImageToGPU(0, y, texture->width, lines, (const u8 *)pb.data());
+		return;
+	}
+	// Twiddled: an aligned block of 2^n pixels is a twiddled texture itself so update the range block by block
+	const u32 bcx = bitscanrev(texture->width);
+	const u32 bcy = bitscanrev(texture->height);
+	u32 pixel = start * 8 / tex->bpp;
+	const u32 endPixel = end * 8 / tex->bpp;
+	while (pixel < endPixel)
+	{
+		u32 blockBits = pixel == 0 ? bcx + bcy : bitscanrev(pixel & (0 - pixel));
+		while (pixel + (1 << blockBits) > endPixel)
+			blockBits--;
+		u32 x, y, w, h;
+		untwiddle(pixel, blockBits, bcx, bcy, x, y, w, h);
+		pb.init(w, h);
+		texconv(&pb, &vram[texture->sa + pixel * tex->bpp / 8], w, h);
+		texture->UploadSubImageToGPU(x, y, w, h, (const u8 *)pb.data());
+		pixel += 1 << blockBits;
+	}
+}
+
 bool BaseTextureCacheData::Update()
 {
 	//texture state tracking stuff
 	Updates++;
-	dirty = 0;
+	const TextureType prevTexType = tex_type;
+	const u32 prevPaletteHash = palette_hash;
+	u32 updateStart = 0;
+	u32 updateEnd = 0;
+	if (partialUpdate)
+	{
+		std::lock_guard<std::mutex> lock(vramlist_lock);
+		// invalidate() starts a new dirty range when dirty is 0, so both must be reset atomically
+		dirty = 0;
+		// The lock is missing if the texture has been replaced by a render-to-texture
+		if (lock_block != nullptr)
+		{
+			updateStart = dirtyStart;
+			updateEnd = dirtyEnd;
+			// Pages that haven't been written are still protected. They will be protected again below.
+			libCore_vramlock_Unlock_block_wb(lock_block);
+			lock_block = nullptr;
+		}
+		dirtyStart = dirtyEnd = 0;
+		partialUpdate = false;
+	}
+	else
+		dirty = 0;
 	gpuPalette = false;
 	tex_type = tex->type;
 
@@ -640,9 +742,6 @@ bool BaseTextureCacheData::Update()
 			return false;
 		}
 	}
-	if (config::CustomTextures)
-		custom_texture.LoadCustomTextureAsync(this);
-
 	void *temp_tex_buffer = NULL;
 	u32 upscaled_w = width;
 	u32 upscaled_h = height;
@@ -657,6 +756,9 @@ bool BaseTextureCacheData::Update()
 			&& (int)(width * height) <= config::MaxFilteredTextureSize * config::MaxFilteredTextureSize
 			// Don't process YUV textures
 			&& tcw.PixelFmt != PixelYUV;
+	// Upload the original texture and replace it once upscaled in the background
+	const bool asyncUpscaling = textureUpscaling && config::BackgroundTextureUpscaling && !config::DumpTextures;
+	bool upscalingQueued = false;
 	bool need_32bit_buffer = true;
 	if (!textureUpscaling
 		&& (!IsPaletted() || tex_type != TextureType::_8888)
@@ -667,6 +769,31 @@ bool BaseTextureCacheData::Update()
 
 	bool mipmapped = IsMipmapped() && !config::DumpTextures;
 
+	// Only the overwritten part of these textures needs to be decoded and uploaded again
+	const bool canUpdatePartially = !IsMipmapped() && !tcw.VQ_Comp && !textureUpscaling
+			&& !config::CustomTextures && !config::DumpTextures
+			&& stride == width && height == original_h
+			&& (texconv != nullptr || texconv32 != nullptr)
+			&& SupportsSubImageUpload();
+	if (updateEnd != 0 && canUpdatePartially && Updates > 1
+			&& (texconv32 != nullptr && need_32bit_buffer ? TextureType::_8888 : tex_type) == prevTexType
+			&& (gpuPalette || palette_hash == prevPaletteHash))
+	{
+		if (texconv32 != nullptr && need_32bit_buffer)
+		{
+			tex_type = TextureType::_8888;
+			updateDirtyRange(this, texconv32, tex, updateStart, updateEnd);
+		}
+		else if (texconv8 != nullptr && tex_type == TextureType::_8)
+			updateDirtyRange(this, texconv8, tex, updateStart, updateEnd);
+		else
+			updateDirtyRange(this, texconv, tex, updateStart, updateEnd);
+		partialUpdate = true;
+		protectVRam();
+
+		return true;
+	}
+
 	if (texconv32 != NULL && need_32bit_buffer)
 	{
 		if (textureUpscaling)
@@ -712,16 +839,23 @@ bool BaseTextureCacheData::Update()
 			// xBRZ scaling
 			if (textureUpscaling)
 			{
-				PixelBuffer<u32> tmp_buf;
-				tmp_buf.init(width * config::TextureUpscale, height * config::TextureUpscale);
-
 				if (tcw.PixelFmt == Pixel1555 || tcw.PixelFmt == Pixel4444)
 					// Alpha channel formats. Palettes with alpha are already handled
 					has_alpha = true;
-				UpscalexBRZ(config::TextureUpscale, pb32.data(), tmp_buf.data(), width, height, has_alpha);
-				pb32.steal_data(tmp_buf);
-				upscaled_w *= config::TextureUpscale;
-				upscaled_h *= config::TextureUpscale;
+				if (asyncUpscaling)
+				{
+					custom_texture.UpscaleTextureAsync(this, pb32.data(), width, height, has_alpha);
+					upscalingQueued = true;
+				}
+				else
+				{
+					PixelBuffer<u32> tmp_buf;
+					tmp_buf.init(width * config::TextureUpscale, height * config::TextureUpscale);
+					UpscalexBRZ(config::TextureUpscale, pb32.data(), tmp_buf.data(), width, height, has_alpha);
+					pb32.steal_data(tmp_buf);
+					upscaled_w *= config::TextureUpscale;
+					upscaled_h *= config::TextureUpscale;
+				}
 			}
 		}
 		temp_tex_buffer = pb32.data();
@@ -794,8 +928,13 @@ bool BaseTextureCacheData::Update()
 	height = original_h;
 
 	//lock the texture to detect changes in it
+	partialUpdate = canUpdatePartially;
 	protectVRam();
 
+	// The upscaling job also looks for a custom texture
+	if (config::CustomTextures && !upscalingQueued)
+		custom_texture.LoadCustomTextureAsync(this);
+
 	UploadToGPU(upscaled_w, upscaled_h, (const u8 *)temp_tex_buffer, IsMipmapped(), mipmapped);
 	if (config::DumpTextures)
 	{
@@ -812,6 +951,13 @@ void BaseTextureCacheData::CheckCustomTexture()
 {
 	if (IsCustomTextureAvailable())
 	{
+		if (custom_updates != Updates)
+		{
+			// Loaded or upscaled from an outdated version of the texture
+			free(custom_image_data);
+			custom_image_data = nullptr;
+			return;
+		}
 		tex_type = TextureType::_8888;
 		gpuPalette = false;
 		UploadToGPU(custom_width, custom_height, custom_image_data, IsMipmapped(), false);
@@ -824,6 +970,10 @@ void BaseTextureCacheData::SetDirectXColorOrder(bool enabled) {
 	pvrTexInfo = enabled ? directx::pvrTexInfo : opengl::pvrTexInfo;
 }
 
+bool BaseTextureCacheData::IsDirectXColorOrder() {
+	return pvrTexInfo == directx::pvrTexInfo;
+}
+
 template<typename Packer>
 void ReadFramebuffer(const FramebufferInfo& info, PixelBuffer<u32>& pb, int& width, int& height)
 {
@@ -1129,8 +1279,25 @@ template void WriteFramebuffer<0, 1, 2, 3>(u32 width, u32 height, const u8 *data
 template void WriteFramebuffer<2, 1, 0, 3>(u32 width, u32 height, const u8 *data, u32 dstAddr, FB_W_CTRL_type fb_w_ctrl,
 		u32 linestride, FB_X_CLIP_type xclip, FB_Y_CLIP_type yclip);
 
-void BaseTextureCacheData::invalidate()
+void BaseTextureCacheData::invalidate(u32 offset)
 {
+	if (partialUpdate)
+	{
+		// Keep the other pages protected to find out which part of the texture is overwritten
+		const u32 pageStart = offset & ~PAGE_MASK;
+		if (dirty == 0)
+		{
+			dirtyStart = pageStart;
+			dirtyEnd = pageStart + PAGE_SIZE;
+		}
+		else if (dirtyEnd != 0)
+		{
+			dirtyStart = std::min(dirtyStart, pageStart);
+			dirtyEnd = std::max(dirtyEnd, pageStart + PAGE_SIZE);
+		}
+		dirty = FrameCount;
+		return;
+	}
 	dirty = FrameCount;
 
 	libCore_vramlock_Unlock_block_wb(lock_block);
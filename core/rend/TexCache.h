@@ -487,6 +487,8 @@ constexpr TexConvFP texPAL4_VQ = texture_VQ<ConvertTwiddlePal4<UnpackerPalToRgb<
 constexpr TexConvFP texPAL8_VQ = texture_VQ<ConvertTwiddlePal8<UnpackerPalToRgb<u16>>>;
 constexpr TexConvFP32 texPAL4_VQ32 = texture_VQ<ConvertTwiddlePal4<UnpackerPalToRgb<u32>>>;
 constexpr TexConvFP32 texPAL8_VQ32 = texture_VQ<ConvertTwiddlePal8<UnpackerPalToRgb<u32>>>;
+constexpr TexConvFP8 texPAL4PT_VQ = texture_VQ<ConvertTwiddlePal4<UnpackerNop<u8>>>;
+constexpr TexConvFP8 texPAL8PT_VQ = texture_VQ<ConvertTwiddlePal8<UnpackerNop<u8>>>;
 
 namespace opengl {
 // OpenGL
@@ -588,6 +590,9 @@ public:
 		sa_tex = other.sa_tex;
 		dirty = other.dirty;
 		std::swap(lock_block, other.lock_block);
+		dirtyStart = other.dirtyStart;
+		dirtyEnd = other.dirtyEnd;
+		partialUpdate = other.partialUpdate;
 		sa = other.sa;
 		width = other.width;
 		height = other.height;
@@ -603,6 +608,7 @@ public:
 		std::swap(custom_image_data, other.custom_image_data);
 		custom_width = other.custom_width;
 		custom_height = other.custom_height;
+		custom_updates = other.custom_updates;
 		custom_load_in_progress = 0;
 		gpuPalette = other.gpuPalette;
 	}
@@ -616,6 +622,9 @@ public:
 
 	u32 dirty;			// frame number at which texture was overwritten
 	vram_block* lock_block;
+	u32 dirtyStart;		// vram range overwritten since the last update, page granularity.
+	u32 dirtyEnd;		// empty if unknown or the whole texture must be updated
+	bool partialUpdate;	// the texture can be partially updated so keep tracking writes after the first one
 
 	u32 sa;         	// pixel data start address of max level mipmap
 	u16 width, height;	// width & height of the texture
@@ -635,6 +644,7 @@ public:
 	u8* custom_image_data;		// loaded custom image data
 	u32 custom_width;
 	u32 custom_height;
+	u32 custom_updates;			// texture update the custom image was loaded for
 	std::atomic_int custom_load_in_progress;
 	bool gpuPalette;
 
@@ -675,6 +685,9 @@ public:
 	bool Update();
 	virtual void UploadToGPU(int width, int height, const u8 *temp_tex_buffer, bool mipmapped, bool mipmapsIncluded = false) = 0;
 	virtual bool Force32BitTexture(TextureType type) const { return false; }
+	// Partial texture updates. Data is in the same format as UploadToGPU.
+	virtual bool SupportsSubImageUpload() const { return false; }
+	virtual void UploadSubImageToGPU(int x, int y, int width, int height, const u8 *data) {}
 	void CheckCustomTexture();
 	//true if : dirty or paletted texture and hashes don't match
 	bool NeedsUpdate();
@@ -682,21 +695,37 @@ public:
 	virtual ~BaseTextureCacheData() = default;
 	void protectVRam();
 	void unprotectVRam();
-	void invalidate();
+	void invalidate(u32 offset);
 
 	static bool IsGpuHandledPaletted(TSP tsp, TCW tcw)
 	{
 		// Some palette textures are handled on the GPU
-		// This is currently limited to textures using nearest filtering and not mipmapped.
+		// This is currently limited to textures that aren't mipmapped. Textures using bilinear filtering
+		// are only supported if the renderer can filter them after the palette lookup.
 		// Enabling texture upscaling or dumping also disables this mode.
 		return (tcw.PixelFmt == PixelPal4 || tcw.PixelFmt == PixelPal8)
 				&& config::TextureUpscale == 1
 				&& !config::DumpTextures
-				&& tsp.FilterMode == 0
-				&& !tcw.MipMapped
-				&& !tcw.VQ_Comp;
+				&& (tsp.FilterMode == 0 || gpuPaletteFiltering)
+				&& !tcw.MipMapped;
+	}
+	// Whether the shader must filter a palette texture handled on the GPU.
+	// The texture itself must always be sampled with nearest filtering.
+	static bool IsGpuPaletteFiltered(TSP tsp)
+	{
+		if (config::TextureFiltering == 0)
+			return tsp.FilterMode != 0;
+		else
+			return config::TextureFiltering == 2;
+	}
+	static void SetGpuPaletteFiltering(bool enabled) {
+		gpuPaletteFiltering = enabled;
 	}
 	static void SetDirectXColorOrder(bool enabled);
+	static bool IsDirectXColorOrder();
+
+private:
+	static bool gpuPaletteFiltering;
 };
 
 // TODO Split the texture cache in a separate header
@@ -113,6 +113,15 @@ void DX11Texture::UploadToGPU(int width, int height, const u8* temp_tex_buffer,
 		theDX11Context.getDeviceContext()->GenerateMips(textureView);
 }
 
+void DX11Texture::UploadSubImageToGPU(int x, int y, int width, int height, const u8 *data)
+{
+	if (texture == nullptr)
+		return;
+	const u32 bpp = tex_type == TextureType::_8888 ? 4 : tex_type == TextureType::_8 ? 1 : 2;
+	D3D11_BOX box{ (UINT)x, (UINT)y, 0, (UINT)(x + width), (UINT)(y + height), 1 };
+	theDX11Context.getDeviceContext()->UpdateSubresource(texture, 0, &box, data, width * bpp, width * bpp * height);
+}
+
 #ifndef TARGET_UWP
 bool DX11Texture::Force32BitTexture(TextureType type) const
 {
@@ -37,6 +37,8 @@ public:
 	std::string GetId() override { return std::to_string((uintptr_t)texture.get()); }
 	void UploadToGPU(int width, int height, const u8* temp_tex_buffer, bool mipmapped,
 			bool mipmapsIncluded = false) override;
+	bool SupportsSubImageUpload() const override { return true; }
+	void UploadSubImageToGPU(int x, int y, int width, int height, const u8 *data) override;
 	bool Delete() override;
 	void loadCustomTexture();
 #ifndef TARGET_UWP
@@ -49,6 +51,7 @@ class DX11TextureCache final : public BaseTextureCache<DX11Texture>
 public:
 	DX11TextureCache() {
 		DX11Texture::SetDirectXColorOrder(true);
+		DX11Texture::SetGpuPaletteFiltering(false);
 	}
 	~DX11TextureCache() {
 		Clear();
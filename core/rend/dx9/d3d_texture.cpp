@@ -106,6 +106,25 @@ void D3DTexture::UploadToGPU(int width, int height, const u8* temp_tex_buffer, b
 	}
 }
 
+void D3DTexture::UploadSubImageToGPU(int x, int y, int width, int height, const u8 *data)
+{
+	if (texture == nullptr)
+		return;
+	const u32 bpp = tex_type == TextureType::_8888 ? 4 : tex_type == TextureType::_8 ? 1 : 2;
+	RECT area{ x, y, x + width, y + height };
+	D3DLOCKED_RECT rect;
+	if (FAILED(texture->LockRect(0, &rect, &area, 0)))
+		return;
+	u8 *dst = (u8 *)rect.pBits;
+	for (int l = 0; l < height; l++)
+	{
+		memcpy(dst, data, width * bpp);
+		dst += rect.Pitch;
+		data += width * bpp;
+	}
+	texture->UnlockRect(0);
+}
+
 bool D3DTexture::Delete()
 {
 	if (!BaseTextureCacheData::Delete())
@@ -33,6 +33,8 @@ public:
 	std::string GetId() override { return std::to_string((uintptr_t)texture.get()); }
 	void UploadToGPU(int width, int height, const u8* temp_tex_buffer, bool mipmapped,
 			bool mipmapsIncluded = false) override;
+	bool SupportsSubImageUpload() const override { return true; }
+	void UploadSubImageToGPU(int x, int y, int width, int height, const u8 *data) override;
 	bool Delete() override;
 	void loadCustomTexture();
 };
@@ -42,6 +44,7 @@ class D3DTextureCache final : public BaseTextureCache<D3DTexture>
 public:
 	D3DTextureCache() {
 		D3DTexture::SetDirectXColorOrder(true);
+		D3DTexture::SetGpuPaletteFiltering(false);
 	}
 	~D3DTextureCache() {
 		Clear();
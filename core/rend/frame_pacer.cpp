@@ -0,0 +1,126 @@
+#include "frame_pacer.h"
+#include "cfg/option.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <thread>
+
+FramePacer framePacer;
+
+// Wake up this long before the deadline and spin for the remaining time
+static constexpr int SpinTime = 2000;
+
+FramePacer::Strategy FramePacer::strategy() const
+{
+	if (config::FixedFrequency != 0)
+		return Timer;
+	if (config::VSync)
+		return Display;
+	if (config::LimitFPS)
+		return Audio;
+	return None;
+}
+
+int FramePacer::period() const
+{
+	// Native NTSC/VGA
+	if (config::FixedFrequency == 2 ||
+		(config::FixedFrequency == 1 &&
+			(config::Cable == 0 || config::Cable == 1)) ||
+		(config::FixedFrequency == 1 && config::Cable == 3 &&
+			(config::Broadcast == 0 || config::Broadcast == 4)))
+		return 16683; // 1/59.94
+	// Approximate VGA
+	if (config::FixedFrequency == 3)
+		return 16666; // 1/60
+	// PAL
+	if (config::FixedFrequency == 4 ||
+			 (config::FixedFrequency == 1 && config::Cable == 3))
+		return 20000; // 1/50
+	// Half Native NTSC/VGA
+	if (config::FixedFrequency == 5)
+		return 33333; // 1/30
+
+	return 16683;
+}
+
+void FramePacer::wait()
+{
+	if (strategy() != Timer || settings.input.fastForwardMode)
+	{
+		deadline = the_clock::time_point();
+		return;
+	}
+	const auto framePeriod = std::chrono::microseconds(period());
+	auto now = the_clock::now();
+	if (deadline == the_clock::time_point() || now > deadline + framePeriod)
+		// First frame or too late to catch up: restart from now
+		deadline = now + framePeriod;
+	else
+		deadline += framePeriod;
+
+	if (config::FixedFrequencyThreadSleep)
+	{
+		// Less precise but doesn't use any cpu
+		std::this_thread::sleep_until(deadline);
+		return;
+	}
+	// The OS scheduler may wake us up late so sleep until shortly before the deadline then spin
+	const auto wakeUp = deadline - std::chrono::microseconds(SpinTime);
+	if (now < wakeUp)
+		std::this_thread::sleep_until(wakeUp);
+	while (the_clock::now() < deadline)
+		std::this_thread::yield();
+}
+
+void FramePacer::framePresented()
+{
+	auto now = the_clock::now();
+	if (lastPresent != the_clock::time_point())
+	{
+		u32 frameTime = (u32)std::chrono::duration_cast<std::chrono::microseconds>(now - lastPresent).count();
+		frameTimeHistogram[std::min<u32>(frameTime / 1000, Buckets - 1)]++;
+		totalFrameTime += frameTime;
+		frameCount++;
+		maxFrameTimeUs = std::max(maxFrameTimeUs, frameTime);
+		// A frame is late if it is presented more than half a period after its expected time
+		const int expected = period();
+		if ((int)frameTime > expected * 3 / 2 && !settings.input.fastForwardMode)
+			missed++;
+	}
+	lastPresent = now;
+}
+
+void FramePacer::reset()
+{
+	deadline = the_clock::time_point();
+	lastPresent = the_clock::time_point();
+	frameTimeHistogram.fill(0.f);
+	totalFrameTime = 0;
+	frameCount = 0;
+	maxFrameTimeUs = 0;
+	missed = 0;
+}
+
+void FramePacer::displayStats()
+{
+	static const char * const strategyNames[] { "None", "Audio", "Display", "Timer" };
+
+	ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 10.f, 10.f), ImGuiCond_Always, ImVec2(1.f, 0.f));	// Upper right corner
+	ImGui::SetNextWindowBgAlpha(0.5f);
+	ImGui::Begin("##framepacing", NULL, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs);
+
+	ImGui::Text("Pacing: %s", strategyNames[strategy()]);
+	if (strategy() == Timer)
+	{
+		ImGui::SameLine();
+		ImGui::Text("%.2f Hz", 1000000.f / period());
+	}
+	ImGui::Text("Avg %.2f ms  Max %.2f ms  Late %u", averageFrameTime(), maxFrameTime(), missed);
+	// Only show the buckets up to the longest frame
+	int buckets = std::min<int>(maxFrameTimeUs / 1000 + 1, Buckets);
+	ImGui::PlotHistogram("##frametimes", frameTimeHistogram.data(), std::max(buckets, 20), 0, "frame time (ms)",
+			0.f, FLT_MAX, ImVec2(200.f * settings.display.uiScale, 60.f * settings.display.uiScale));
+
+	ImGui::End();
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "types.h"
+
+#include <array>
+#include <chrono>
+
+// Paces the main loop and collects frame time statistics.
+// The strategy is selected by the existing options:
+// - Timer: Fixed Frequency is enabled. Frames are presented at the selected frequency using the host timer.
+// - Display: VSync is enabled. The swap chain paces the frames.
+// - Audio: Audio Frame Sync is enabled. Emulation blocks on the audio output.
+class FramePacer
+{
+public:
+	enum Strategy {
+		None,
+		Audio,
+		Display,
+		Timer
+	};
+
+	Strategy strategy() const;
+	// Target frame duration in microseconds when using the timer
+	int period() const;
+
+	// Wait until the next frame deadline. Does nothing unless using the timer.
+	void wait();
+	// Must be called right after each emulated frame has been presented
+	void framePresented();
+	void reset();
+
+	// Frame time histogram: 1 ms per bucket, the last one collecting longer frames
+	static constexpr int Buckets = 50;
+	const std::array<float, Buckets>& histogram() const { return frameTimeHistogram; }
+	float averageFrameTime() const { return frameCount == 0 ? 0.f : (float)(totalFrameTime / frameCount) / 1000.f; }
+	float maxFrameTime() const { return maxFrameTimeUs / 1000.f; }
+	u32 missedDeadlines() const { return missed; }
+
+	// Display the frame time statistics
+	void displayStats();
+
+private:
+	using the_clock = std::chrono::steady_clock;
+
+	the_clock::time_point deadline;
+	the_clock::time_point lastPresent;
+	std::array<float, Buckets> frameTimeHistogram {};
+	u64 totalFrameTime = 0;
+	u64 frameCount = 0;
+	u32 maxFrameTimeUs = 0;
+	u32 missed = 0;
+};
+
+extern FramePacer framePacer;
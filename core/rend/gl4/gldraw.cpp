@@ -35,7 +35,7 @@ GLuint depthSaveTexId;
 static gl4PipelineShader *gl4GetProgram(bool cp_AlphaTest, bool pp_InsideClipping,
 							bool pp_Texture, bool pp_UseAlpha, bool pp_IgnoreTexA, u32 pp_ShadInstr, bool pp_Offset,
 							u32 pp_FogCtrl, bool pp_TwoVolumes, bool pp_Gouraud, bool pp_BumpMap, bool fog_clamping,
-							bool palette, bool naomi2, Pass pass)
+							int palette, bool naomi2, Pass pass)
 {
 	u32 rv=0;
 
@@ -51,7 +51,7 @@ static gl4PipelineShader *gl4GetProgram(bool cp_AlphaTest, bool pp_InsideClippin
 	rv <<= 1; rv |= (int)pp_Gouraud;
 	rv <<= 1; rv |= (int)pp_BumpMap;
 	rv <<= 1; rv |= (int)fog_clamping;
-	rv <<= 1; rv |= (int)palette;
+	rv <<= 2; rv |= palette;
 	rv <<= 1; rv |= (int)naomi2;
 	rv <<= 2; rv |= (int)pass;
 	rv <<= 1; rv |= (int)(!settings.platform.isNaomi2() && config::NativeDepthInterpolation);
@@ -157,7 +157,7 @@ static void SetGPState(const PolyParam* gp)
 				gp->pcw.Gouraud,
 				gp->tcw.PixelFmt == PixelBumpMap,
 				color_clamp,
-				gpuPalette,
+				!gpuPalette ? 0 : BaseTextureCacheData::IsGpuPaletteFiltered(gp->tsp) ? 2 : 1,
 				gp->isNaomi2(),
 				pass);
 	}
@@ -222,7 +222,10 @@ static void SetGPState(const PolyParam* gp)
 				SetTextureRepeatMode(i, GL_TEXTURE_WRAP_T, tsp.ClampV, tsp.FlipV);
 
 				bool nearest_filter;
-				if (config::TextureFiltering == 0) {
+				if (texture->gpuPalette) {
+					// Filtered by the shader if needed
+					nearest_filter = true;
+				} else if (config::TextureFiltering == 0) {
 					nearest_filter = tsp.FilterMode == 0;
 				} else if (config::TextureFiltering == 1) {
 					nearest_filter = true;
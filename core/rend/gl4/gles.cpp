@@ -162,7 +162,7 @@ uniform sampler2D DepthTex;
 uniform float trilinear_alpha;
 uniform vec4 fog_clamp_min;
 uniform vec4 fog_clamp_max;
-#if pp_Palette == 1
+#if pp_Palette != 0
 uniform sampler2D palette;
 uniform int palette_index;
 #endif
@@ -211,20 +211,43 @@ vec4 fog_clamp(vec4 col)
 #endif
 }
 
-#if pp_Palette == 1
+#if pp_Palette != 0
 
-vec4 palettePixel(sampler2D tex, vec3 coords)
+vec4 getPaletteEntry(float colIdx)
 {
-#if DIV_POS_Z == 1
-	float colIdx = texture(tex, coords.xy).r;
-#else
-	float colIdx = textureProj(tex, coords).r;
-#endif
 	int color_idx = int(floor(colIdx * 255.0 + 0.5)) + palette_index;
 	ivec2 c = ivec2(color_idx % 32, color_idx / 32);
 	return texelFetch(palette, c, 0);
 }
 
+vec4 palettePixel(sampler2D tex, vec3 coords)
+{
+#if pp_Palette == 1
+	#if DIV_POS_Z == 1
+		float colIdx = texture(tex, coords.xy).r;
+	#else
+		float colIdx = textureProj(tex, coords).r;
+	#endif
+	return getPaletteEntry(colIdx);
+#else
+	// Bilinear filtering after the palette lookup. The index texture is sampled with nearest filtering.
+	#if DIV_POS_Z == 1
+		vec2 uv = coords.xy;
+	#else
+		vec2 uv = coords.xy / coords.z;
+	#endif
+	vec2 texSize = vec2(textureSize(tex, 0));
+	vec2 pos = uv * texSize - 0.5;
+	vec2 f = fract(pos);
+	vec2 texel = (floor(pos) + 0.5) / texSize;
+	vec4 c00 = getPaletteEntry(texture(tex, texel).r);
+	vec4 c10 = getPaletteEntry(texture(tex, texel + vec2(1.0 / texSize.x, 0.0)).r);
+	vec4 c01 = getPaletteEntry(texture(tex, texel + vec2(0.0, 1.0 / texSize.y)).r);
+	vec4 c11 = getPaletteEntry(texture(tex, texel + 1.0 / texSize).r);
+	return mix(mix(c00, c10, f.x), mix(c01, c11, f.x), f.y);
+#endif
+}
+
 #endif
 
 void main()
@@ -744,6 +767,7 @@ bool OpenGL4Renderer::Init()
 	fog_needs_update = true;
 	forcePaletteUpdate();
 	TextureCacheData::SetDirectXColorOrder(false);
+	TextureCacheData::SetGpuPaletteFiltering(true);
 
 	return true;
 }
@@ -1006,6 +1006,7 @@ bool OpenGLRenderer::Init()
 	fog_needs_update = true;
 	forcePaletteUpdate();
 	TextureCacheData::SetDirectXColorOrder(false);
+	TextureCacheData::SetGpuPaletteFiltering(false);
 
 	return true;
 }
@@ -378,6 +378,8 @@ public:
 	GLuint texID;   //gl texture
 	std::string GetId() override { return std::to_string(texID); }
 	void UploadToGPU(int width, int height, const u8 *temp_tex_buffer, bool mipmapped, bool mipmapsIncluded = false) override;
+	bool SupportsSubImageUpload() const override { return true; }
+	void UploadSubImageToGPU(int x, int y, int width, int height, const u8 *data) override;
 	bool Delete() override;
 };
 
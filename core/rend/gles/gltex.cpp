@@ -9,12 +9,9 @@ GlTextureCache TexCache;
 
 static void readAsyncPixelBuffer(u32 addr);
 
-void TextureCacheData::UploadToGPU(int width, int height, const u8 *temp_tex_buffer, bool mipmapped, bool mipmapsIncluded)
+static u32 getGLFormat(TextureType tex_type, GLuint& comps, GLuint& gltype)
 {
-	//upload to OpenGL !
-	glcache.BindTexture(GL_TEXTURE_2D, texID);
-	GLuint comps = tex_type == TextureType::_8 ? gl.single_channel_format : GL_RGBA;
-	GLuint gltype;
+	comps = tex_type == TextureType::_8 ? gl.single_channel_format : GL_RGBA;
 	u32 bytes_per_pixel = 2;
 	switch (tex_type)
 	{
@@ -41,6 +38,16 @@ void TextureCacheData::UploadToGPU(int width, int height, const u8 *temp_tex_buf
 		gltype = 0;
 		break;
 	}
+	return bytes_per_pixel;
+}
+
+void TextureCacheData::UploadToGPU(int width, int height, const u8 *temp_tex_buffer, bool mipmapped, bool mipmapsIncluded)
+{
+	//upload to OpenGL !
+	glcache.BindTexture(GL_TEXTURE_2D, texID);
+	GLuint comps;
+	GLuint gltype;
+	u32 bytes_per_pixel = getGLFormat(tex_type, comps, gltype);
 	if (mipmapsIncluded)
 	{
 		int mipmapLevels = 0;
@@ -107,6 +114,16 @@ void TextureCacheData::UploadToGPU(int width, int height, const u8 *temp_tex_buf
 	}
 	glCheck();
 }
+
+void TextureCacheData::UploadSubImageToGPU(int x, int y, int width, int height, const u8 *data)
+{
+	glcache.BindTexture(GL_TEXTURE_2D, texID);
+	GLuint comps;
+	GLuint gltype;
+	getGLFormat(tex_type, comps, gltype);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, comps, gltype, data);
+	glCheck();
+}
 	
 bool TextureCacheData::Delete()
 {
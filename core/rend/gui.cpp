@@ -39,6 +39,7 @@
 #include "lua/lua.h"
 #include "gui_chat.h"
 #include "imgui_driver.h"
+#include "frame_pacer.h"
 #include "implot/implot.h"
 #include "boxart/boxart.h"
 #include "profiler/fc_profiler.h"
@@ -2692,6 +2693,10 @@ static void settings_body_controls(ImVec2 normal_padding)
 	    	OptionSlider("Mouse sensitivity", config::MouseSensitivity, 1, 500);
 #if defined(_WIN32) && !defined(TARGET_UWP)
 	    	OptionCheckbox("Use Raw Input", config::UseRawInput, "Supports multiple pointing devices (mice, light guns) and keyboards");
+#endif
+#if defined(__linux__) && !defined(__ANDROID__)
+			OptionCheckbox("Just-in-time Input Polling", config::JitInputPolling,
+					"Read gamepads right before the game reads the controllers. Reduces input lag with multi-threaded emulation");
 #endif
 			OptionCheckbox("Enable Diagonal Correction", config::EnableDiagonalCorrection, "Smooths out transitions from detected diagonal inputs to adjacent directions. Ideal for keyboard players.");
 
@@ -4470,8 +4475,14 @@ static std::string getFPSNotification()
 			lastFrameCount = MainFrameCount;
 		}
 		if (fps >= 0.f && fps < 9999.f) {
-			char text[32];
-			snprintf(text, sizeof(text), "F:%.1f%s", fps, settings.input.fastForwardMode ? " >>" : "");
+			char text[64];
+			AudioStreamStats audioStats = GetAudioStreamStats();
+			if (audioStats.active)
+				snprintf(text, sizeof(text), "F:%.1f A:%dms/%dms U:%d%s", fps,
+						audioStats.fill * 1000 / 44100, audioStats.target * 1000 / 44100, audioStats.underruns,
+						settings.input.fastForwardMode ? " >>" : "");
+			else
+				snprintf(text, sizeof(text), "F:%.1f%s", fps, settings.input.fastForwardMode ? " >>" : "");
 
 			return std::string(text);
 		}
@@ -4507,6 +4518,8 @@ void gui_display_osd()
 		imguiDriver->displayCrosshairs();
 		if (config::FloatVMUs)
 			imguiDriver->displayVmus();
+		if (config::ShowFrameTiming)
+			framePacer.displayStats();
 //		gui_plot_render_time(settings.display.width, settings.display.height);
 		if (ggpo::active() && !dojo.PlayMatch)
 		{
@@ -20,8 +20,10 @@
 #include "imgui/imgui.h"
 #include "gui_util.h"
 #include "cheats.h"
+#include "cheat_search.h"
 
 static bool addingCheat;
+static bool searchingCheat;
 
 static void addCheat()
 {
@@ -67,6 +69,107 @@ static void addCheat()
 	ImGui::End();
 }
 
+static std::string formatValue(u32 value)
+{
+	char s[32];
+	if (cheatSearch.valueType() == CheatSearch::ValueType::Float)
+	{
+		f32 f;
+		memcpy(&f, &value, sizeof(f));
+		snprintf(s, sizeof(s), "%g", f);
+	}
+	else
+		snprintf(s, sizeof(s), "%u", value);
+	return s;
+}
+
+static u32 parseValue(const char *s)
+{
+	if (cheatSearch.valueType() == CheatSearch::ValueType::Float)
+	{
+		f32 f = (f32)atof(s);
+		u32 value;
+		memcpy(&value, &f, sizeof(value));
+		return value;
+	}
+	return (u32)strtoul(s, nullptr, 0);
+}
+
+static void searchCheat()
+{
+	static int valueType = 2;
+	static char value[32];
+	const size_t MaxResults = 100;
+
+    centerNextWindow();
+    ImGui::SetNextWindowSize(min(ImGui::GetIO().DisplaySize, ScaledVec2(600.f, 400.f)));
+
+    ImGui::Begin("##main", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoTitleBar
+    		| ImGuiWindowFlags_NoMove | ImGuiWindowFlags_AlwaysAutoResize);
+
+    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ScaledVec2(20, 8));
+    ImGui::AlignTextToFramePadding();
+    ImGui::Indent(10 * settings.display.uiScale);
+    ImGui::Text("SEARCH MEMORY");
+
+	ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - ImGui::CalcTextSize("Close").x - ImGui::GetStyle().FramePadding.x * 2.f);
+	if (ImGui::Button("Close"))
+		searchingCheat = false;
+
+    ImGui::Unindent(10 * settings.display.uiScale);
+    ImGui::PopStyleVar();
+
+	ImGui::BeginChild(ImGui::GetID("search"), ImVec2(0, 0), true, ImGuiWindowFlags_DragScrolling);
+    {
+		const char *types[] = { "8-bit", "16-bit", "32-bit", "Float" };
+		ImGui::Combo("Type", &valueType, types, ARRAY_SIZE(types));
+		ImGui::InputText("Value", value, sizeof(value), ImGuiInputTextFlags_CharsNoBlank, nullptr, nullptr);
+		if (ImGui::Button("New Search"))
+			cheatSearch.start((CheatSearch::ValueType)valueType);
+		if (cheatSearch.started())
+		{
+			ImGui::SameLine();
+			if (ImGui::Button("Equal"))
+				cheatSearch.search(CheatSearch::Condition::Equal, parseValue(value));
+			ImGui::SameLine();
+			if (ImGui::Button("Changed"))
+				cheatSearch.search(CheatSearch::Condition::Changed);
+			ImGui::SameLine();
+			if (ImGui::Button("Unchanged"))
+				cheatSearch.search(CheatSearch::Condition::Unchanged);
+			ImGui::SameLine();
+			if (ImGui::Button("Increased"))
+				cheatSearch.search(CheatSearch::Condition::Increased);
+			ImGui::SameLine();
+			if (ImGui::Button("Decreased"))
+				cheatSearch.search(CheatSearch::Condition::Decreased);
+
+			ImGui::Text("%zd matching addresses", cheatSearch.candidateCount());
+			if (cheatSearch.candidateCount() <= MaxResults)
+			{
+				for (u32 address : cheatSearch.results(MaxResults))
+				{
+					ImGui::PushID(address);
+					const u32 current = cheatSearch.previousValue(address);
+					ImGui::AlignTextToFramePadding();
+					ImGui::Text("%06x: %s", address, formatValue(current).c_str());
+					ImGui::SameLine();
+					if (ImGui::Button("Add Cheat"))
+					{
+						// Freeze the address to the searched value if any, or its current value
+						char name[32];
+						snprintf(name, sizeof(name), "RAM %06x", address);
+						cheatManager.addCheat(cheatSearch.makeCheat(name, address, value[0] != '\0' ? parseValue(value) : current));
+					}
+					ImGui::PopID();
+				}
+			}
+		}
+    }
+	ImGui::EndChild();
+	ImGui::End();
+}
+
 void gui_cheats()
 {
 	if (addingCheat)
@@ -74,6 +177,11 @@ void gui_cheats()
 		addCheat();
 		return;
 	}
+	if (searchingCheat)
+	{
+		searchCheat();
+		return;
+	}
     centerNextWindow();
     ImGui::SetNextWindowSize(min(ImGui::GetIO().DisplaySize, ScaledVec2(600.f, 400.f)));
 
@@ -85,11 +193,14 @@ void gui_cheats()
     ImGui::Indent(10 * settings.display.uiScale);
     ImGui::Text("CHEATS");
 
-	ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - ImGui::CalcTextSize("Add").x  - ImGui::CalcTextSize("Close").x - ImGui::GetStyle().FramePadding.x * 8.f
-    	- ImGui::CalcTextSize("Load").x - ImGui::CalcTextSize("Unload").x - ImGui::GetStyle().ItemSpacing.x * 6);
+	ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - ImGui::CalcTextSize("Add").x  - ImGui::CalcTextSize("Close").x - ImGui::GetStyle().FramePadding.x * 10.f
+    	- ImGui::CalcTextSize("Search").x - ImGui::CalcTextSize("Load").x - ImGui::CalcTextSize("Unload").x - ImGui::GetStyle().ItemSpacing.x * 8);
 	if (ImGui::Button("Add"))
 		addingCheat = true;
 	ImGui::SameLine();
+	if (ImGui::Button("Search"))
+		searchingCheat = true;
+	ImGui::SameLine();
 	if (ImGui::Button("Load"))
     	ImGui::OpenPopup("Select cheat file");
 	select_file_popup("Select cheat file", [](bool cancelled, std::string selection)
@@ -186,6 +186,8 @@ void GuiSettings::settings_body_audio(ImVec2 normal_padding)
 	OptionCheckbox("Audio Frame Sync", config::LimitFPS, "Sync frames with audio output");
 	OptionCheckbox("Enable DSP", config::DSPEnabled,
 				   "Enable the Dreamcast Digital Sound Processor. Only recommended on fast platforms");
+	OptionCheckbox("Threaded Sound CPU", config::ThreadedSoundCpu,
+				   "Run the sound CPU on a separate thread. Not used during netplay. May cause audio glitches in some games");
 	if (OptionSlider("Volume Level", config::AudioVolume, 0, 100, "Adjust the emulator's audio level"))
 	{
 		config::AudioVolume.calcDbPower();
@@ -203,6 +205,16 @@ void GuiSettings::settings_body_audio(ImVec2 normal_padding)
 		ImGui::SameLine();
 		ShowHelpMarker("Sets the maximum audio latency. Not supported by all audio drivers.");
 	}
+	OptionCheckbox("Audio Stream Buffer", config::AudioRingBuffer,
+				   "Feed the audio driver from a separate thread and resample to absorb clock drift. Audio output no longer blocks emulation unless Audio Frame Sync is enabled");
+	if (config::AudioRingBuffer)
+	{
+		int latency = (int)roundf(config::AudioRingLatency * 1000.f / 44100.f);
+		ImGui::SliderInt("Stream Latency", &latency, 12, 256, "%d ms");
+		config::AudioRingLatency = (int)roundf(latency * 44100.f / 1000.f);
+		ImGui::SameLine();
+		ShowHelpMarker("Target latency of the audio stream buffer");
+	}
 
 	AudioBackend *backend = nullptr;
 	std::string backend_name = config::AudioBackend;
@@ -281,6 +293,14 @@ void GuiSettings::settings_body_audio(ImVec2 normal_padding)
 					ImGui::EndCombo();
 				}
 			}
+			else if (options->type == AudioBackend::Option::text)
+			{
+				char text[256];
+				strncpy(text, value.c_str(), sizeof(text) - 1);
+				text[sizeof(text) - 1] = '\0';
+				if (ImGui::InputText(options->caption.c_str(), text, sizeof(text), ImGuiInputTextFlags_EnterReturnsTrue, nullptr, nullptr))
+					cfgSaveStr(current_backend->slug, options->name, text);
+			}
 			else
 			{
 				WARN_LOG(RENDERER, "Unknown option");
@@ -435,6 +455,8 @@ void GuiSettings::settings_body_advanced(ImVec2 normal_padding)
 		ImGui::SameLine();
 		ShowHelpMarker("Specify lua filename to use. Should be located in Flycast config directory. Defaults to flycast.lua when empty.");
 		config::LuaFileName = LuaFileName;
+		OptionCheckbox("Asynchronous VBlank Callback", config::LuaAsyncVBlank,
+				"Run the Lua vblank callback on a separate thread. The script reads a copy of the memory regions it watches and its inputs and state changes take effect at the next frame");
 	}
 #endif
 }
@@ -957,6 +979,7 @@ void GuiSettings::settings_body_video(ImVec2 normal_padding)
 	header("On-Screen Display");
 	{
 		OptionCheckbox("Show FPS Counter", config::ShowFPS, "Show on-screen frame/sec counter");
+		OptionCheckbox("Show Frame Timing", config::ShowFrameTiming, "Show the frame pacing strategy, a frame time histogram and the number of late frames");
 		OptionCheckbox("Show VMU In-game", config::FloatVMUs, "Show the VMU LCD screens while in-game");
 	}
 
@@ -1027,6 +1050,9 @@ void GuiSettings::settings_body_video(ImVec2 normal_padding)
 								   "Upscale textures with the xBRZ algorithm. Only on fast platforms and for certain 2D games");
 				OptionSlider("Texture Max Size", config::MaxFilteredTextureSize, 8, 1024,
 							 "Textures larger than this dimension squared will not be upscaled");
+				OptionCheckbox("Upscale in Background", config::BackgroundTextureUpscaling,
+							   "Display the original textures until they have been upscaled in the background. "
+							   "Upscaled textures are saved in data/texcache/<game id>");
 				OptionArrowButtons("Max Threads", config::MaxThreads, 1, 8,
 								   "Maximum number of threads to use for texture upscaling. Recommended: number of physical cores minus one");
 #endif
@@ -1081,6 +1107,12 @@ void GuiSettings::settings_body_video(ImVec2 normal_padding)
 							"Helps with texture bleeding case when upscaling. Disabling it can help if pixels are warping when upscaling in 2D games (MVC2, CVS, KOF, etc.)");
 			OptionCheckbox("Native Depth Interpolation", config::NativeDepthInterpolation,
 						   "Helps with texture corruption and depth issues on AMD GPUs. Can also help Intel GPUs in some cases.");
+			{
+				DisabledScope scope(config::ThreadedRendering);
+				OptionSlider("Run-Ahead Frames", config::RunAhead, 0, 4,
+						"Reduce input lag by emulating frames ahead and rolling back. Each frame requires emulating the game one more time. "
+						"Not available with multi-threaded emulation or netplay.");
+			}
 		}
 
 		ImGui::Spacing();
@@ -26,8 +26,10 @@
 #include "emulator.h"
 #include "imgui_driver.h"
 #include "profiler/fc_profiler.h"
+#include "input/gamepad_device.h"
+#include "profiler/latency.h"
+#include "frame_pacer.h"
 
-#include <atomic>
 #include <chrono>
 #include <thread>
 
@@ -41,57 +43,14 @@ static bool forceReinit;
 
 void UpdateInputState();
 
-std::atomic<bool> display_refresh(false);
-
-void display_refresh_thread()
-{
-	auto dispStart = std::chrono::steady_clock::now();
-	long long period = 16683; // Native NTSC/VGA by default
-	while(1)
-	{
-		// Native NTSC/VGA
-		if (config::FixedFrequency == 2 ||
-			(config::FixedFrequency == 1 &&
-				(config::Cable == 0 || config::Cable == 1)) ||
-			(config::FixedFrequency == 1 && config::Cable == 3 &&
-				(config::Broadcast == 0 || config::Broadcast == 4)))
-			period = 16683; // 1/59.94
-		// Approximate VGA
-		else if (config::FixedFrequency == 3)
-			period = 16666; // 1/60
-		// PAL
-		else if (config::FixedFrequency == 4 ||
-				 (config::FixedFrequency == 1 && config::Cable == 3))
-			period = 20000; // 1/50
-		// Half Native NTSC/VGA
-		else if (config::FixedFrequency == 5)
-			period = 33333; // 1/30
-
-		auto now = std::chrono::steady_clock::now();
-		long long duration = std::chrono::duration_cast<std::chrono::microseconds>(now - dispStart).count();
-		if (duration > period)
-		{
-			display_refresh.exchange(true);
-			dispStart = now;
-
-			if(!settings.input.fastForwardMode && config::FixedFrequencyThreadSleep)
-				std::this_thread::sleep_for(std::chrono::microseconds(2000));
-		}
-	}
-}
-
-void start_display_refresh_thread()
-{
-	std::thread t1(&display_refresh_thread);
-	t1.detach();
-}
-
 bool mainui_rend_frame()
 {
 	FC_PROFILE_SCOPE;
 
 	os_DoEvents();
 	UpdateInputState();
+	latency::update();
+	GamepadDevice::handleDeferredInputs();
 
 	if (gui_is_open() || gui_state == GuiState::VJoyEdit)
 	{
@@ -144,52 +103,23 @@ void mainui_loop()
 	timeBeginPeriod(1);
 #endif
 
-	if (config::FixedFrequency != 0)
-		start_display_refresh_thread();
-
-	long long period = 16683; // Native NTSC/VGA by default
-	std::chrono::time_point<std::chrono::steady_clock> start;
-
 	while (mainui_enabled)
 	{
 		fc_profiler::startThread("main");
 
-		if (mainui_rend_frame())
-		{
-			// Native NTSC/VGA
-			if (config::FixedFrequency == 2 ||
-				(config::FixedFrequency == 1 &&
-					(config::Cable == 0 || config::Cable == 1)) ||
-				(config::FixedFrequency == 1 && config::Cable == 3 &&
-					(config::Broadcast == 0 || config::Broadcast == 4)))
-				period = 16683; // 1/59.94
-			// Approximate VGA
-			else if (config::FixedFrequency == 3)
-				period = 16666; // 1/60
-			// PAL
-			else if (config::FixedFrequency == 4 ||
-					 (config::FixedFrequency == 1 && config::Cable == 3))
-				period = 20000; // 1/50
-			// Half Native NTSC/VGA
-			else if (config::FixedFrequency == 5)
-				period = 33333; // 1/30
-
-			if (config::FixedFrequency != 0 &&
-				!gui_is_open() &&
-				!settings.input.fastForwardMode)
-			{
-				while(!display_refresh.load());
-				display_refresh.exchange(false);
-
-				if (config::FixedFrequencyThreadSleep)
-					start = std::chrono::steady_clock::now();
-			}
-		}
+		bool frameRendered = mainui_rend_frame() && !gui_is_open();
+		if (frameRendered)
+			framePacer.wait();
+		else if (gui_is_open())
+			// Restart the statistics when the game resumes
+			framePacer.reset();
 
 		if (imguiDriver == nullptr)
 			forceReinit = true;
 		else
 			imguiDriver->present();
+		if (frameRendered)
+			framePacer.framePresented();
 
 		if (config::RendererType != currentRenderer || forceReinit)
 		{
@@ -203,19 +133,6 @@ void mainui_loop()
 			currentRenderer = config::RendererType;
 		}
 
-		if (config::FixedFrequencyThreadSleep &&
-			!gui_is_open() &&
-			!settings.input.fastForwardMode)
-		{
-			auto end = std::chrono::steady_clock::now();
-			long long duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-
-			if (duration < period - 3000)
-			{
-				std::this_thread::sleep_for(std::chrono::microseconds(1000));
-			}
-		}
-
 		fc_profiler::endThread(config::ProfilerFrameWarningTime);
 	}
 
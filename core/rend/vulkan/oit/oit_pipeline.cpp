@@ -153,7 +153,7 @@ void OITPipelineManager::CreatePipeline(u32 listType, bool autosort, const PolyP
 	params.useAlpha = pp.tsp.UseAlpha;
 	params.pass = pass;
 	params.twoVolume = twoVolume;
-	params.palette = gpuPalette;
+	params.palette = !gpuPalette ? 0 : BaseTextureCacheData::IsGpuPaletteFiltered(pp.tsp) ? 2 : 1;
 	params.divPosZ = divPosZ;
 	vk::ShaderModule fragment_module = shaderManager->GetFragmentShader(params);
 
@@ -165,14 +165,14 @@ public:
 			vk::DescriptorImageInfo imageInfo0;
 			if (poly.texture != nullptr)
 			{
-				imageInfo0 = vk::DescriptorImageInfo{ samplerManager->GetSampler(poly.tsp), ((Texture *)poly.texture)->GetReadOnlyImageView(),
+				imageInfo0 = vk::DescriptorImageInfo{ samplerManager->GetSampler(poly.tsp, poly.texture->gpuPalette), ((Texture *)poly.texture)->GetReadOnlyImageView(),
 						vk::ImageLayout::eShaderReadOnlyOptimal };
 				writeDescriptorSets.emplace_back(perPolyDescSet, 0, 0, vk::DescriptorType::eCombinedImageSampler, imageInfo0);
 			}
 			vk::DescriptorImageInfo imageInfo1;
 			if (poly.texture1 != nullptr)
 			{
-				imageInfo1 = vk::DescriptorImageInfo{ samplerManager->GetSampler(poly.tsp1), ((Texture *)poly.texture1)->GetReadOnlyImageView(),
+				imageInfo1 = vk::DescriptorImageInfo{ samplerManager->GetSampler(poly.tsp1, poly.texture1->gpuPalette), ((Texture *)poly.texture1)->GetReadOnlyImageView(),
 					vk::ImageLayout::eShaderReadOnlyOptimal };
 				writeDescriptorSets.emplace_back(perPolyDescSet, 1, 0, vk::DescriptorType::eCombinedImageSampler, imageInfo1);
 			}
@@ -331,7 +331,7 @@ public:
 
 	vk::Pipeline GetPipeline(u32 listType, bool autosort, const PolyParam& pp, Pass pass, bool gpuPalette)
 	{
-		u32 pipehash = hash(listType, autosort, &pp, pass, gpuPalette);
+		u64 pipehash = hash(listType, autosort, &pp, pass, gpuPalette);
 		const auto &pipeline = pipelines.find(pipehash);
 		if (pipeline != pipelines.end())
 			return pipeline->second.get();
@@ -387,15 +387,15 @@ private:
 	void CreateModVolPipeline(ModVolMode mode, int cullMode, bool naomi2);
 	void CreateTrModVolPipeline(ModVolMode mode, int cullMode, bool naomi2);
 
-	u32 hash(u32 listType, bool autosort, const PolyParam *pp, Pass pass, bool gpuPalette) const
+	u64 hash(u32 listType, bool autosort, const PolyParam *pp, Pass pass, bool gpuPalette) const
 	{
-		u32 hash = pp->pcw.Gouraud | (pp->pcw.Offset << 1) | (pp->pcw.Texture << 2) | (pp->pcw.Shadow << 3)
+		u64 hash = pp->pcw.Gouraud | (pp->pcw.Offset << 1) | (pp->pcw.Texture << 2) | (pp->pcw.Shadow << 3)
 			| (((pp->tileclip >> 28) == 3) << 4);
 		hash |= ((listType >> 1) << 5);
 		if (pp->tcw1.full != (u32)-1 || pp->tsp1.full != (u32)-1)
 		{
 			// Two-volume mode
-			hash |= (1 << 31) | (pp->tsp.ColorClamp << 11);
+			hash |= (1u << 31) | (pp->tsp.ColorClamp << 11);
 		}
 		else
 		{
@@ -407,6 +407,7 @@ private:
 		hash |= (pp->isp.ZWriteDis << 20) | (pp->isp.CullMode << 21) | ((autosort ? 6 : pp->isp.DepthMode) << 23);
 		hash |= ((u32)gpuPalette << 26) | ((u32)pass << 27) | ((u32)pp->isNaomi2() << 29);
 		hash |= (u32)(!settings.platform.isNaomi2() && config::NativeDepthInterpolation) << 30;
+		hash |= (u64)(gpuPalette && BaseTextureCacheData::IsGpuPaletteFiltered(pp->tsp)) << 32;
 
 		return hash;
 	}
@@ -449,7 +450,7 @@ private:
 	void CreateFinalPipeline();
 	void CreateClearPipeline();
 
-	std::map<u32, vk::UniquePipeline> pipelines;
+	std::map<u64, vk::UniquePipeline> pipelines;
 	std::map<u32, vk::UniquePipeline> modVolPipelines;
 	std::map<u32, vk::UniquePipeline> trModVolPipelines;
 	vk::UniquePipeline finalPipeline;
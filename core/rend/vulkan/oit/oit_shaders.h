@@ -58,7 +58,7 @@ public:
 		bool bumpmap;
 		bool clamping;
 		bool twoVolume;
-		bool palette;
+		int palette;	// 0: none, 1: nearest, 2: bilinear filtering
 		bool divPosZ;
 		Pass pass;
 
@@ -68,7 +68,7 @@ public:
 				| ((u32)texture << 3) | ((u32)ignoreTexAlpha << 4) | (shaderInstr << 5)
 				| ((u32)offset << 7) | ((u32)fog << 8) | ((u32)gouraud << 10)
 				| ((u32)bumpmap << 11) | ((u32)clamping << 12) | ((u32)twoVolume << 13)
-				| ((u32)palette << 14) | ((int)pass << 15) | ((u32)divPosZ << 17);
+				| ((u32)palette << 14) | ((int)pass << 16) | ((u32)divPosZ << 18);
 		}
 	};
 
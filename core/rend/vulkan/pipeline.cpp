@@ -402,7 +402,7 @@ void PipelineManager::CreatePipeline(u32 listType, bool sortTriangles, const Pol
 	params.texture = pp.pcw.Texture;
 	params.trilinear = pp.pcw.Texture && pp.tsp.FilterMode > 1 && listType != ListType_Punch_Through && pp.tcw.MipMapped == 1;
 	params.useAlpha = pp.tsp.UseAlpha;
-	params.palette = gpuPalette;
+	params.palette = !gpuPalette ? 0 : BaseTextureCacheData::IsGpuPaletteFiltered(pp.tsp) ? 2 : 1;
 	params.divPosZ = divPosZ;
 	vk::ShaderModule fragment_module = shaderManager->GetFragmentShader(params);
 
@@ -89,7 +89,7 @@ public:
 			vk::DescriptorImageInfo imageInfo;
 			if (poly.texture != nullptr)
 			{
-				imageInfo = vk::DescriptorImageInfo(samplerManager->GetSampler(poly.tsp),
+				imageInfo = vk::DescriptorImageInfo(samplerManager->GetSampler(poly.tsp, poly.texture->gpuPalette),
 						((Texture *)poly.texture)->GetReadOnlyImageView(), vk::ImageLayout::eShaderReadOnlyOptimal);
 				writeDescriptorSets.emplace_back(perPolyDescSet, 0, 0, vk::DescriptorType::eCombinedImageSampler, imageInfo);
 			}
@@ -276,6 +276,7 @@ private:
 		hash |= (pp->isp.ZWriteDis << 20) | (pp->isp.CullMode << 21) | (pp->isp.DepthMode << 23);
 		hash |= ((u32)sortTriangles << 26) | ((u32)gpuPalette << 27) | ((u32)pp->isNaomi2() << 28);
 		hash |= (u32)(!settings.platform.isNaomi2() && config::NativeDepthInterpolation) << 29;
+		hash |= (u32)(gpuPalette && BaseTextureCacheData::IsGpuPaletteFiltered(pp->tsp)) << 30;
 
 		return hash;
 	}
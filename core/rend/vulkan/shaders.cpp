@@ -88,7 +88,7 @@ layout (push_constant) uniform pushBlock
 #if pp_Texture == 1
 layout (set = 1, binding = 0) uniform sampler2D tex;
 #endif
-#if pp_Palette == 1
+#if pp_Palette != 0
 layout (set = 0, binding = 3) uniform sampler2D palette;
 #endif
 
@@ -126,17 +126,40 @@ vec4 colorClamp(vec4 col)
 #endif
 }
 
-#if pp_Palette == 1
+#if pp_Palette != 0
+
+vec4 getPaletteEntry(float colorIndex)
+{
+	vec4 c = vec4(colorIndex * 255.0 / 1023.0 + pushConstants.palette_index, 0.5, 0.0, 0.0);
+	return texture(palette, c.xy);
+}
 
 vec4 palettePixel(sampler2D tex, vec3 coords)
 {
-#if DIV_POS_Z == 1
-	float texIdx = texture(tex, coords.xy).r;
+#if pp_Palette == 1
+	#if DIV_POS_Z == 1
+		float texIdx = texture(tex, coords.xy).r;
+	#else
+		float texIdx = textureProj(tex, coords).r;
+	#endif
+	return getPaletteEntry(texIdx);
 #else
-	float texIdx = textureProj(tex, coords).r;
+	// Bilinear filtering after the palette lookup. The index texture is sampled with nearest filtering.
+	#if DIV_POS_Z == 1
+		vec2 uv = coords.xy;
+	#else
+		vec2 uv = coords.xy / coords.z;
+	#endif
+	vec2 texSize = vec2(textureSize(tex, 0));
+	vec2 pos = uv * texSize - 0.5;
+	vec2 f = fract(pos);
+	vec2 texel = (floor(pos) + 0.5) / texSize;
+	vec4 c00 = getPaletteEntry(texture(tex, texel).r);
+	vec4 c10 = getPaletteEntry(texture(tex, texel + vec2(1.0 / texSize.x, 0.0)).r);
+	vec4 c01 = getPaletteEntry(texture(tex, texel + vec2(0.0, 1.0 / texSize.y)).r);
+	vec4 c11 = getPaletteEntry(texture(tex, texel + 1.0 / texSize).r);
+	return mix(mix(c00, c10, f.x), mix(c01, c11, f.x), f.y);
 #endif
-	vec4 c = vec4(texIdx * 255.0 / 1023.0 + pushConstants.palette_index, 0.5, 0.0, 0.0);
-	return texture(palette, c.xy);
 }
 
 #endif
@@ -49,7 +49,7 @@ struct FragmentShaderParams
 	bool bumpmap;
 	bool clamping;
 	bool trilinear;
-	bool palette;
+	int palette;	// 0: none, 1: nearest, 2: bilinear filtering
 	bool divPosZ;
 
 	u32 hash()
@@ -58,7 +58,7 @@ struct FragmentShaderParams
 			| ((u32)texture << 3) | ((u32)ignoreTexAlpha << 4) | (shaderInstr << 5)
 			| ((u32)offset << 7) | ((u32)fog << 8) | ((u32)gouraud << 10)
 			| ((u32)bumpmap << 11) | ((u32)clamping << 12) | ((u32)trilinear << 13)
-			| ((u32)palette << 14) | ((u32)divPosZ << 15);
+			| ((u32)palette << 14) | ((u32)divPosZ << 16);
 	}
 };
 
@@ -99,14 +99,17 @@ public:
 		samplers.clear();
 	}
 
-	vk::Sampler GetSampler(TSP tsp)
+	// Palette textures handled on the GPU must use nearest filtering
+	vk::Sampler GetSampler(TSP tsp, bool forceNearest = false)
 	{
-		const u32 samplerHash = tsp.full & TSP_Mask;	// MipMapD, FilterMode, ClampU, ClampV, FlipU, FlipV
+		const u32 samplerHash = (tsp.full & TSP_Mask) | ((u32)forceNearest << 31);	// MipMapD, FilterMode, ClampU, ClampV, FlipU, FlipV
 		const auto& it = samplers.find(samplerHash);
 		if (it != samplers.end())
 			return it->second.get();
 		vk::Filter filter;
-		if (config::TextureFiltering == 0) {
+		if (forceNearest) {
+			filter = vk::Filter::eNearest;
+		} else if (config::TextureFiltering == 0) {
 			filter = tsp.FilterMode == 0 ? vk::Filter::eNearest : vk::Filter::eLinear;
 		} else if (config::TextureFiltering == 1) {
 			filter = vk::Filter::eNearest;
@@ -175,6 +178,7 @@ class TextureCache final : public BaseTextureCache<Texture>
 public:
 	TextureCache() {
 		Texture::SetDirectXColorOrder(false);
+		Texture::SetGpuPaletteFiltering(true);
 	}
 	void SetCurrentIndex(int index) {
 		if (currentIndex < inFlightTextures.size())
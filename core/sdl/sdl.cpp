@@ -27,6 +27,7 @@
 #ifdef __SWITCH__
 #include "nswitch.h"
 #endif
+#include <mutex>
 
 static SDL_Window* window = NULL;
 static u32 windowFlags;
@@ -240,6 +241,71 @@ inline void SDLMouse::setAbsPos(int x, int y) {
 		Mouse::setAbsPos(x, y, width, height);
 }
 
+// Joystick events can be handled by the main thread or by the emulation thread
+// when just-in-time input polling is enabled
+static std::mutex joystickMutex;
+
+static void handleJoystickEvent(const SDL_Event& event)
+{
+	switch (event.type)
+	{
+		case SDL_JOYBUTTONDOWN:
+		case SDL_JOYBUTTONUP:
+			{
+				std::shared_ptr<SDLGamepad> device = SDLGamepad::GetSDLGamepad((SDL_JoystickID)event.jbutton.which);
+				if (device != NULL)
+					device->gamepad_btn_input(event.jbutton.button, event.type == SDL_JOYBUTTONDOWN);
+			}
+			break;
+		case SDL_JOYAXISMOTION:
+			{
+				std::shared_ptr<SDLGamepad> device = SDLGamepad::GetSDLGamepad((SDL_JoystickID)event.jaxis.which);
+				if (device != NULL)
+					device->gamepad_axis_input(event.jaxis.axis, event.jaxis.value);
+			}
+			break;
+		case SDL_JOYHATMOTION:
+			{
+				std::shared_ptr<SDLGamepad> device = SDLGamepad::GetSDLGamepad((SDL_JoystickID)event.jhat.which);
+				if (device != NULL)
+				{
+					u32 hatid = (event.jhat.hat + 1) << 8;
+					if (event.jhat.value & SDL_HAT_UP)
+					{
+						device->gamepad_btn_input(hatid + 0, true);
+						device->gamepad_btn_input(hatid + 1, false);
+					}
+					else if (event.jhat.value & SDL_HAT_DOWN)
+					{
+						device->gamepad_btn_input(hatid + 0, false);
+						device->gamepad_btn_input(hatid + 1, true);
+					}
+					else
+					{
+						device->gamepad_btn_input(hatid + 0, false);
+						device->gamepad_btn_input(hatid + 1, false);
+					}
+					if (event.jhat.value & SDL_HAT_LEFT)
+					{
+						device->gamepad_btn_input(hatid + 2, true);
+						device->gamepad_btn_input(hatid + 3, false);
+					}
+					else if (event.jhat.value & SDL_HAT_RIGHT)
+					{
+						device->gamepad_btn_input(hatid + 2, false);
+						device->gamepad_btn_input(hatid + 3, true);
+					}
+					else
+					{
+						device->gamepad_btn_input(hatid + 2, false);
+						device->gamepad_btn_input(hatid + 3, false);
+					}
+				}
+			}
+			break;
+	}
+}
+
 void input_sdl_handle()
 {
 	SDLGamepad::UpdateRumble();
@@ -323,56 +389,11 @@ void input_sdl_handle()
 
 			case SDL_JOYBUTTONDOWN:
 			case SDL_JOYBUTTONUP:
-				{
-					std::shared_ptr<SDLGamepad> device = SDLGamepad::GetSDLGamepad((SDL_JoystickID)event.jbutton.which);
-					if (device != NULL)
-						device->gamepad_btn_input(event.jbutton.button, event.type == SDL_JOYBUTTONDOWN);
-				}
-				break;
 			case SDL_JOYAXISMOTION:
-				{
-					std::shared_ptr<SDLGamepad> device = SDLGamepad::GetSDLGamepad((SDL_JoystickID)event.jaxis.which);
-					if (device != NULL)
-						device->gamepad_axis_input(event.jaxis.axis, event.jaxis.value);
-				}
-				break;
 			case SDL_JOYHATMOTION:
 				{
-					std::shared_ptr<SDLGamepad> device = SDLGamepad::GetSDLGamepad((SDL_JoystickID)event.jhat.which);
-					if (device != NULL)
-					{
-						u32 hatid = (event.jhat.hat + 1) << 8;
-						if (event.jhat.value & SDL_HAT_UP)
-						{
-							device->gamepad_btn_input(hatid + 0, true);
-							device->gamepad_btn_input(hatid + 1, false);
-						}
-						else if (event.jhat.value & SDL_HAT_DOWN)
-						{
-							device->gamepad_btn_input(hatid + 0, false);
-							device->gamepad_btn_input(hatid + 1, true);
-						}
-						else
-						{
-							device->gamepad_btn_input(hatid + 0, false);
-							device->gamepad_btn_input(hatid + 1, false);
-						}
-						if (event.jhat.value & SDL_HAT_LEFT)
-						{
-							device->gamepad_btn_input(hatid + 2, true);
-							device->gamepad_btn_input(hatid + 3, false);
-						}
-						else if (event.jhat.value & SDL_HAT_RIGHT)
-						{
-							device->gamepad_btn_input(hatid + 2, false);
-							device->gamepad_btn_input(hatid + 3, true);
-						}
-						else
-						{
-							device->gamepad_btn_input(hatid + 2, false);
-							device->gamepad_btn_input(hatid + 3, false);
-						}
-					}
+					std::lock_guard<std::mutex> lock(joystickMutex);
+					handleJoystickEvent(event);
 				}
 				break;
 
@@ -440,16 +461,34 @@ void input_sdl_handle()
 				break;
 
 			case SDL_JOYDEVICEADDED:
-				sdl_open_joystick(event.jdevice.which);
+				{
+					std::lock_guard<std::mutex> lock(joystickMutex);
+					sdl_open_joystick(event.jdevice.which);
+				}
 				break;
 
 			case SDL_JOYDEVICEREMOVED:
-				sdl_close_joystick((SDL_JoystickID)event.jdevice.which);
+				{
+					std::lock_guard<std::mutex> lock(joystickMutex);
+					sdl_close_joystick((SDL_JoystickID)event.jdevice.which);
+				}
 				break;
 		}
 	}
 }
 
+// Update the joysticks and handle their events. Can be called from any thread.
+void input_sdl_poll_joysticks()
+{
+	std::lock_guard<std::mutex> lock(joystickMutex);
+	SDL_JoystickUpdate();
+	SDL_Event events[16];
+	int count;
+	while ((count = SDL_PeepEvents(events, ARRAY_SIZE(events), SDL_GETEVENT, SDL_JOYAXISMOTION, SDL_JOYBUTTONUP)) > 0)
+		for (int i = 0; i < count; i++)
+			handleJoystickEvent(events[i]);
+}
+
 void sdl_window_set_text(const char* text)
 {
 	if (window != nullptr)
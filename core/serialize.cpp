@@ -3,6 +3,7 @@
 #include "types.h"
 #include "hw/aica/dsp.h"
 #include "hw/aica/aica.h"
+#include "hw/aica/aica_if.h"
 #include "hw/aica/sgc_if.h"
 #include "hw/arm7/arm7.h"
 #include "hw/holly/sb.h"
@@ -153,6 +154,7 @@ static const std::array<int, 11> getSchedulerIds() {
 
 void dc_serialize(Serializer& ser)
 {
+	libAICA_Sync();
 	ser << aica_interr;
 	ser << aica_reg_L;
 	ser << e68k_out;
@@ -306,6 +308,7 @@ void dc_serialize(Serializer& ser)
 
 static void dc_deserialize_libretro(Deserializer& deser)
 {
+	libAICA_Sync();
 	deser >> aica_interr;
 	deser >> aica_reg_L;
 	deser >> e68k_out;
@@ -594,6 +597,7 @@ void dc_deserialize(Deserializer& deser)
 		return;
 	}
 	DEBUG_LOG(SAVESTATE, "Loading state version %d", deser.version());
+	libAICA_Sync();
 
 	deser >> aica_interr;
 	deser >> aica_reg_L;
@@ -182,15 +182,26 @@ public:
 	}
 	void skip(size_t size)
 	{
+		checkLimit(size);
 		if (data != nullptr)
 			data += size;
 		this->_size += size;
 	}
 	bool dryrun() const { return data == nullptr; }
+	// true if the buffer was too small. size() is then the required size.
+	bool overflow() const { return _size > limit; }
 
 private:
+	// Switch to a dry run if the buffer is too small so that the required size is still computed
+	void checkLimit(size_t size)
+	{
+		if (data != nullptr && this->_size + size > limit)
+			data = nullptr;
+	}
+
 	void doSerialize(const void *src, size_t size)
 	{
+		checkLimit(size);
 		if (data != nullptr)
 		{
 			memcpy(data, src, size);
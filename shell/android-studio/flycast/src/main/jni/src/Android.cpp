@@ -351,7 +351,11 @@ extern "C" JNIEXPORT void JNICALL Java_com_reicast_emulator_emu_JNIdc_pause(JNIE
 		stopEmu();
 		game_started = true; // restart when resumed
 		if (config::AutoSaveState)
+		{
 			dc_savestate(config::SavestateSlot);
+			// the app may be killed while paused
+			dc_waitSavestate();
+		}
 	}
 	gui_save();
 }
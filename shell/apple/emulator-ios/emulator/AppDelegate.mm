@@ -68,7 +68,11 @@ static bool emulatorRunning;
     // If your application supports background execution, this method is called instead of applicationWillTerminate: when the user quits.
     gui_save();
 	if (config::AutoSaveState && !settings.content.path.empty())
+	{
 		dc_savestate(config::SavestateSlot);
+		// the app may be suspended or terminated once in the background
+		dc_waitSavestate();
+	}
 }
 
 - (void)applicationWillEnterForeground:(UIApplication *)application
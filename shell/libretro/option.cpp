@@ -48,6 +48,9 @@ Option<int> AudioBufferSize("", 5644);	// 128 ms
 Option<int> AudioBufferSize("", 2822);	// 64 ms
 #endif
 Option<bool> AutoLatency("");
+Option<bool> ThreadedSoundCpu("");
+Option<bool> AudioRingBuffer("");
+Option<int> AudioRingLatency("", 2205);	// 50 ms
 
 OptionString AudioBackend("", "auto");
 
@@ -63,12 +66,14 @@ Option<bool> TranslucentPolygonDepthMask("");
 Option<bool> ModifierVolumes(CORE_OPTION_NAME "_volume_modifier_enable", true);
 IntOption TextureUpscale(CORE_OPTION_NAME "_texupscale", 1);
 IntOption MaxFilteredTextureSize(CORE_OPTION_NAME "_texupscale_max_filtered_texture_size", 256);
+Option<bool> BackgroundTextureUpscaling("");
 Option<float> ExtraDepthScale("", 1.f);
 Option<bool> CustomTextures(CORE_OPTION_NAME "_custom_textures");
 Option<bool> DumpTextures(CORE_OPTION_NAME "_dump_textures");
 Option<int> ScreenStretching("", 100);
 Option<bool> Fog(CORE_OPTION_NAME "_fog", true);
 Option<bool> FloatVMUs("");
+Option<bool> ShowFrameTiming("");
 Option<bool> Rotate90("");
 Option<bool> PerStripSorting("rend.PerStripSorting");
 Option<bool> DelayFrameSwapping(CORE_OPTION_NAME "_delay_frame_swapping");
@@ -93,11 +98,13 @@ IntOption PerPixelLayers(CORE_OPTION_NAME "_oit_layers");
 Option<bool> NativeDepthInterpolation(CORE_OPTION_NAME "_native_depth_interpolation");
 Option<bool> EmulateFramebuffer(CORE_OPTION_NAME "_emulate_framebuffer", false);
 Option<bool> FixUpscaleBleedingEdge(CORE_OPTION_NAME "_fix_upscale_bleeding_edge", true);
+Option<int> RunAhead("", 0);	// handled by the frontend
 
 // Misc
 
 Option<bool> SerialConsole("");
 Option<bool> SerialPTY("");
+Option<int> LatencyTest("", 0);
 Option<bool> UseReios(CORE_OPTION_NAME "_hle_bios");
 
 Option<bool> OpenGlChecks("", false);
@@ -125,6 +132,7 @@ Option<bool> NetworkOutput(CORE_OPTION_NAME "_network_output", false);
 
 Option<int> MouseSensitivity("", 100);
 Option<int> VirtualGamepadVibration("", 20);
+Option<bool> JitInputPolling("");
 
 std::array<Option<MapleDeviceType>, 4> MapleMainDevices {
 	Option<MapleDeviceType>("", MDT_None),
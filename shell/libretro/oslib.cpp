@@ -124,6 +124,12 @@ std::string getTextureDumpPath()
 			+ "texdump" + std::string(path_default_slash());
 }
 
+std::string getTextureCachePath()
+{
+	return std::string(game_dir_no_slash) + std::string(path_default_slash())
+			+ "texcache" + std::string(path_default_slash());
+}
+
 std::string getBiosFontPath()
 {
 	return std::string(game_dir_no_slash) + std::string(path_default_slash()) + "font.bin";
@@ -136,6 +142,10 @@ void dc_savestate(int index = 0)
 	die("unsupported");
 }
 
+void dc_waitSavestate()
+{
+}
+
 void dc_loadstate(int index = 0)
 {
 	die("unsupported");
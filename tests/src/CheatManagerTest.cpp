@@ -3,6 +3,7 @@
 #include "cfg/ini.h"
 #include "cfg/cfg.h"
 #include "cheats.h"
+#include "cheat_search.h"
 #include "emulator.h"
 #include "hw/sh4/sh4_mem.h"
 
@@ -305,3 +306,92 @@ cheats = "2"
 	ASSERT_EQ(2, ReadMem8_nommu(0x8c010001));
 
 }
+
+TEST_F(CheatManagerTest, TestCondition)
+{
+	FILE *fp = fopen("test.cht", "w");
+	const char *s = R"(
+cheat0_address = "0x10000"
+cheat0_cheat_type = "4"
+cheat0_desc = "if equal"
+cheat0_memory_search_size = "3"
+cheat0_value = "1"
+cheat1_address = "0x10004"
+cheat1_cheat_type = "1"
+cheat1_desc = "conditional"
+cheat1_memory_search_size = "3"
+cheat1_value = "0x55"
+cheat2_address = "0x10008"
+cheat2_cheat_type = "1"
+cheat2_desc = "unconditional"
+cheat2_memory_search_size = "3"
+cheat2_value = "0x66"
+cheats = "3"
+)";
+	fputs(s, fp);
+	fclose(fp);
+
+	CheatManager mgr;
+	mgr.reset("TESTCOND");
+	mgr.loadCheatFile("test.cht");
+	mem_map_default();
+	dc_reset(true);
+
+	mgr.enableCheat(0, true);
+	mgr.enableCheat(1, true);
+	mgr.enableCheat(2, true);
+	WriteMem8_nommu(0x8c010000, 0);
+	mgr.apply();
+	ASSERT_EQ(0, ReadMem8_nommu(0x8c010004));
+	ASSERT_EQ(0x66, ReadMem8_nommu(0x8c010008));
+
+	WriteMem8_nommu(0x8c010000, 1);
+	mgr.apply();
+	ASSERT_EQ(0x55, ReadMem8_nommu(0x8c010004));
+
+	// the condition must not apply to the following cheat when the next one is disabled
+	mgr.enableCheat(1, false);
+	WriteMem8_nommu(0x8c010000, 0);
+	WriteMem8_nommu(0x8c010004, 0);
+	WriteMem8_nommu(0x8c010008, 0);
+	mgr.apply();
+	ASSERT_EQ(0, ReadMem8_nommu(0x8c010004));
+	ASSERT_EQ(0x66, ReadMem8_nommu(0x8c010008));
+}
+
+TEST_F(CheatManagerTest, TestSearch)
+{
+	std::vector<u8> ram(64 * 1024);
+	u16 *ram16 = (u16 *)ram.data();
+	ram16[0x100] = 100;
+	ram16[0x200] = 100;
+	ram16[0x300] = 100;
+
+	CheatSearch search;
+	search.start(CheatSearch::ValueType::Int16, ram.data(), ram.size());
+	ASSERT_EQ(ram.size() / 2, search.candidateCount());
+	search.search(CheatSearch::Condition::Equal, 100, ram.data());
+	ASSERT_EQ(3u, search.candidateCount());
+
+	ram16[0x100] = 99;
+	ram16[0x200] = 101;
+	search.search(CheatSearch::Condition::Changed, 0, ram.data());
+	ASSERT_EQ(2u, search.candidateCount());
+	search.search(CheatSearch::Condition::Unchanged, 0, ram.data());
+	ASSERT_EQ(2u, search.candidateCount());
+
+	ram16[0x100] = 98;
+	ram16[0x200] = 102;
+	search.search(CheatSearch::Condition::Decreased, 0, ram.data());
+	ASSERT_EQ(1u, search.candidateCount());
+	std::vector<u32> results = search.results(10);
+	ASSERT_EQ(1u, results.size());
+	ASSERT_EQ(0x200u, results[0]);
+	ASSERT_EQ(98u, search.previousValue(0x200));
+
+	Cheat cheat = search.makeCheat("test", results[0], 50);
+	ASSERT_EQ(Cheat::Type::setValue, cheat.type);
+	ASSERT_EQ(16u, cheat.size);
+	ASSERT_EQ(0x200u, cheat.address);
+	ASSERT_EQ(50u, cheat.value);
+}